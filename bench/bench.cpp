@@ -0,0 +1,139 @@
+#include "../include/array.hpp"
+#include "../include/factory.hpp"
+#include "../include/containment.hpp"
+#include "../include/array_diff.hpp"
+#include "../include/loader.hpp"
+#include <cstdio>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace {
+
+std::mt19937 rng(42);
+
+double uniform(double lo, double hi) {
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+// Правильные многоугольники со случайным центром в квадрате [0, extent]^2
+Array randomFigures(size_t count, double extent) {
+    static const size_t sides[] = {5, 6, 8};
+    Array array;
+    for (size_t i = 0; i < count; ++i) {
+        size_t n = sides[i % 3];
+        double cx = uniform(0, extent), cy = uniform(0, extent);
+        double r = uniform(0.5, 2.0), rotation = uniform(0, 2 * M_PI);
+        std::vector<Point> verts;
+        for (size_t k = 0; k < n; ++k) {
+            double angle = rotation + 2 * M_PI * k / n;
+            verts.push_back({cx + r * std::cos(angle), cy + r * std::sin(angle)});
+        }
+        array.addFigure(createFigure(std::move(verts)));
+    }
+    return array;
+}
+
+std::vector<Point> randomPoints(size_t count, double extent) {
+    std::vector<Point> points;
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back({uniform(0, extent), uniform(0, extent)});
+    }
+    return points;
+}
+
+template <typename Func>
+void measure(const std::string& name, Func func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms" << std::endl;
+}
+
+void benchContainment() {
+    for (size_t figures : {1000, 10000}) {
+        for (size_t points : {1000, 10000}) {
+            Array array = randomFigures(figures, 100);
+            std::vector<Point> queries = randomPoints(points, 100);
+            size_t hits = 0;
+
+            std::unique_ptr<ContainmentIndex> index;
+            measure("containment build " + std::to_string(figures) + " figures", [&] {
+                index = std::make_unique<ContainmentIndex>(array);
+            });
+            measure("containment " + std::to_string(figures) + " figures x " + std::to_string(points) + " points", [&] {
+                for (const auto& list : index->query(queries)) {
+                    hits += list.size();
+                }
+            });
+            std::cout << "  hits: " << hits << std::endl;
+        }
+    }
+}
+
+void benchOverlap() {
+    for (size_t figures : {10000, 100000}) {
+        Array array = randomFigures(figures, std::sqrt(static_cast<double>(figures)) * 10);
+        size_t pairs = 0;
+
+        measure("overlap " + std::to_string(figures) + " figures", [&] {
+            pairs = array.findOverlappingPairs().size();
+        });
+        std::cout << "  pairs: " << pairs << std::endl;
+    }
+}
+
+void benchRanking() {
+    Array array = randomFigures(1000000, 1000);
+
+    measure("topK area 100 of 1000000", [&] {
+        array.topK(Metric::Area, 100);
+    });
+    measure("sortBy area 1000000", [&] {
+        array.sortBy(Metric::Area);
+    });
+}
+
+void benchDiff() {
+    rng.seed(7);
+    Array before = randomFigures(200000, 1000);
+    rng.seed(7);
+    Array after = randomFigures(200000, 1000);
+    after.removeFigure(0);
+
+    size_t unchanged = 0;
+    measure("diff 200000 vs 199999 figures", [&] {
+        unchanged = diff(before, after).unchanged.size();
+    });
+    std::cout << "  unchanged: " << unchanged << std::endl;
+}
+
+void benchLoad() {
+    const char* path = "bench_dataset.txt";
+    {
+        std::ofstream out(path);
+        saveDataset(out, randomFigures(200000, 1000));
+    }
+
+    size_t loaded = 0;
+    measure("pipelined load 200000 figures", [&] {
+        loaded = loadDataset(path).figures.size();
+    });
+    std::cout << "  loaded: " << loaded << std::endl;
+    std::remove(path);
+}
+
+}
+
+int main() {
+    benchContainment();
+    benchOverlap();
+    benchRanking();
+    benchDiff();
+    benchLoad();
+    return 0;
+}
@@ -0,0 +1,19 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+#include "figure.hpp"
+#include "array.hpp"
+
+// Сжатый бинарный формат коллекции фигур.
+// Координаты квантуются с шагом QUANTUM (ошибка не больше QUANTUM / 2,
+// то есть восстановленные точки равны исходным по Point::operator==),
+// вершины фигуры кодируются разностями от предыдущей вершины в zigzag varint.
+// Фигуры группируются в независимые блоки, которые декодируются параллельно.
+class Archive {
+public:
+    static constexpr double QUANTUM = 1e-6;
+
+    static void write(std::ostream& os, const Array& array, size_t blockSize = 4096);
+    static Array read(std::istream& is);
+};
+
+#endif
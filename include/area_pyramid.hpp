@@ -0,0 +1,89 @@
+#ifndef AREA_PYRAMID_H
+#define AREA_PYRAMID_H
+#include "figure.hpp"
+#include "array.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+// Пирамида сумм площадей по центрам фигур: уровень L делит bounds на
+// 2^L x 2^L ячеек, в каждой хранятся количество и суммарная площадь.
+// Ячейки, целиком попавшие в запрос, берутся из сумм, граничные листья
+// проверяются по центрам фигур, поэтому ответ точный. Фигуры с центром вне
+// bounds хранятся отдельным списком и проверяются по одной; когда список
+// разрастается, bounds перестраиваются по центрам всех фигур.
+//
+// Фигуры различаются по адресу. Удаленная из Array фигура попадает в пул
+// и может вернуться из acquire() по тому же адресу, поэтому пирамида
+// должна узнать об удалении раньше, чем фигура будет переиспользована.
+// Пирамида, подключенная через attach(), получает уведомления от Array и
+// это требование выполняется само; при ручных add/remove вызывающий
+// обязан вызвать remove до Array::removeFigure.
+class AreaPyramid : public ArrayObserver {
+public:
+    struct RegionTotal {
+        size_t count = 0;
+        double area = 0;
+    };
+
+private:
+    struct Entry {
+        Point center;
+        double area;
+        size_t leaf;
+    };
+
+    static constexpr size_t OUTSIDE = SIZE_MAX;
+
+    BoundingBox bounds;
+    size_t depth;
+    std::vector<std::vector<RegionTotal>> levels;
+    std::vector<std::vector<const Figure*>> leaves;
+    std::vector<const Figure*> outside;
+    std::unordered_map<const Figure*, Entry> entries;
+    size_t rebuildAt;
+
+    size_t leafOf(const Point& center) const;
+    void place(const Figure* figure, Entry entry);
+    void rebuildBounds(const Point& pending);
+    void update(size_t leaf, double area, int delta);
+    void collect(size_t level, size_t cx, size_t cy, const BoundingBox& region, RegionTotal& total) const;
+    void collectExact(const std::vector<const Figure*>& figures, const BoundingBox& region, RegionTotal& total) const;
+
+public:
+    AreaPyramid(const BoundingBox& bounds, size_t depth = 7);
+    // Границы берутся по центрам фигур массива
+    explicit AreaPyramid(const Array& array, size_t depth = 7);
+
+    // Строит пирамиду по фигурам массива и подписывает ее на его изменения
+    static std::shared_ptr<AreaPyramid> attach(Array& array, size_t depth = 7);
+
+    void add(const Figure* figure);
+    void remove(const Figure* figure);
+    void clear() noexcept;
+
+    void figureAdded(const Figure* figure) override {
+        add(figure);
+    }
+
+    void figureRemoved(const Figure* figure) override {
+        remove(figure);
+    }
+
+    void cleared() noexcept override {
+        clear();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    // Количество фигур с центром вне bounds
+    size_t outsideCount() const {
+        return outside.size();
+    }
+
+    RegionTotal query(const BoundingBox& region) const;
+};
+
+#endif
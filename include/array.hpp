@@ -1,12 +1,55 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 #include "figure.hpp"
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct ArrayMemoryUsage {
+    MemoryUsage total;
+    MemoryUsage storage;
+    MemoryUsage pool;
+    std::unordered_map<std::type_index, MemoryUsage> byType;
+    std::unordered_map<std::type_index, size_t> countByType;
+};
+
+struct TypeSummary {
+    size_t count = 0;
+    double totalArea = 0;
+    double meanArea = 0;
+    std::vector<size_t> histogram;  // последняя корзина включает все большие площади
+    Point centroid;                 // среднее центров фигур типа
+};
+
+// Получает уведомления об изменении состава Array. figureAdded и
+// figureRemoved вызываются после всех шагов, которые могут бросить
+// исключение, но до изменения массива; если наблюдатель бросит исключение,
+// массив останется прежним. figureRemoved вызывается до того, как фигура
+// попадет в пул или будет удалена, поэтому наблюдатель может хранить
+// указатели на фигуры. cleared вызывается и из деструктора Array.
+class ArrayObserver {
+public:
+    virtual ~ArrayObserver() = default;
+
+    virtual void figureAdded(const Figure* figure) = 0;
+    virtual void figureRemoved(const Figure* figure) = 0;
+    virtual void cleared() noexcept = 0;
+};
+
+enum class Metric { Area, CenterX, CenterY, VertexCount };
 
 class Array {
 private:
     Figure** figures;           
     size_t capacity;          
     size_t size_;              
+    std::unordered_map<std::type_index, std::vector<Figure*>> pool;
+    size_t poolLimit;
+    std::shared_ptr<ArrayObserver> observer;
     
     void resize();             
 
@@ -24,14 +67,92 @@ public:
     void removeFigure(int index);
     double totalArea() const;
     void printAllFigures(std::ostream& os) const;
+
+    // Пары индексов (i < j) пересекающихся фигур; невыпуклые фигуры
+    // сравниваются по выпуклым оболочкам
+    std::vector<std::pair<size_t, size_t>> findOverlappingPairs() const;
+
+    // Ключи вычисляются один раз для каждой фигуры
+    std::vector<double> metricColumn(Metric metric) const;
+    void sortBy(Metric metric, bool descending = false);
+    // Индексы k фигур с наибольшим значением метрики, по убыванию
+    std::vector<size_t> topK(Metric metric, size_t k) const;
     
     size_t size() const { 
         return size_; 
     }
     
     Figure* operator[](int index) const;
+
+    // Доступ без проверки границ и итераторы по хранилищу указателей.
+    // Перестановка указателей (например, std::sort) не меняет владения.
+    Figure* get(size_t index) const noexcept {
+        return figures[index];
+    }
+
+    using iterator = Figure**;
+    using const_iterator = Figure* const*;
+
+    iterator begin() noexcept { return figures; }
+    iterator end() noexcept { return figures + size_; }
+    const_iterator begin() const noexcept { return figures; }
+    const_iterator end() const noexcept { return figures + size_; }
+    const_iterator cbegin() const noexcept { return figures; }
+    const_iterator cend() const noexcept { return figures + size_; }
+
+    std::span<Figure* const> view() const noexcept {
+        return std::span<Figure* const>(figures, size_);
+    }
     
     void clear();
+
+    // Удаленные фигуры не освобождаются, а попадают в пул своего типа,
+    // пока в нем меньше poolLimit фигур; сверх лимита они удаляются.
+    // acquire<T>() возвращает фигуру из пула без вершин, но с выделенной под
+    // них памятью, или новую; владение переходит к вызывающему до addFigure.
+    template <typename T>
+    T* acquire() {
+        static_assert(std::is_base_of_v<Figure, T>, "acquire() requires a Figure type");
+        auto it = pool.find(typeid(T));
+        if (it == pool.end() || it->second.empty()) {
+            return new T();
+        }
+        Figure* figure = it->second.back();
+        it->second.pop_back();
+        figure->clearVertices();
+        return static_cast<T*>(figure);
+    }
+
+    // Память массива указателей, фигур и пула; сам объект Array не входит,
+    // служебные узлы хеш-таблицы пула не учитываются
+    ArrayMemoryUsage memoryUsage() const;
+
+    // Количество фигур в параметрической форме правильного многоугольника
+    size_t regularCount() const;
+    void releaseVertexCaches();
+
+    // Сводка по типам фигур (Figure::figureType) за один параллельный проход.
+    // Площади распределяются по binCount корзинам ширины binWidth.
+    // Фигура с площадью NaN - std::invalid_argument.
+    std::unordered_map<std::type_index, TypeSummary> aggregateByType(double binWidth = 1.0, size_t binCount = 10) const;
+
+    static constexpr size_t DEFAULT_POOL_LIMIT = 64;
+
+    // Лимит пула на каждый тип; 0 отключает переиспользование.
+    // Лишние фигуры из уже заполненных пулов удаляются сразу.
+    void setPoolLimit(size_t limit);
+    size_t getPoolLimit() const {
+        return poolLimit;
+    }
+
+    size_t pooledCount() const;
+    void releasePool();
+
+    // Наблюдатель должен уже учитывать фигуры массива; nullptr отключает
+    // уведомления. При перемещении Array наблюдатель переходит вместе с фигурами.
+    void setObserver(std::shared_ptr<ArrayObserver> newObserver) {
+        observer = std::move(newObserver);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef ARRAY_DIFF_H
+#define ARRAY_DIFF_H
+#include "array.hpp"
+
+struct ArrayDiff {
+    std::vector<size_t> added;                          // индексы в after
+    std::vector<size_t> removed;                        // индексы в before
+    std::vector<std::pair<size_t, size_t>> unchanged;   // (before, after)
+};
+
+// Сравнение двух версий коллекции за почти линейное время.
+// Фигуры группируются по типу и ячейке центра размером с допуск
+// Point::operator==, внутри ячейки - по равенству первой фигуре группы.
+// Кандидаты из соседних ячеек сверяются через Figure::operator== с первой
+// несопоставленной фигурой каждой группы, так что дубликаты не
+// перебираются заново. Каждая фигура сопоставляется не более одного раза.
+// Центр с координатой по модулю от 9e12 или NaN - std::out_of_range.
+ArrayDiff diff(const Array& before, const Array& after);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef COMPACT_ARRAY_H
+#define COMPACT_ARRAY_H
+#include "figure.hpp"
+#include "array.hpp"
+#include <cstdint>
+
+// Компактное хранилище вершин коллекции фигур.
+// Это отдельный контейнер рядом с Array, а не режим хранения внутри Figure:
+// Figure::getVertices() отдает ссылку на std::vector<Point>, поэтому
+// фигура не может хранить вершины в другом формате. Данные переносятся
+// через addFigures(Array) и toArray(). Всего не больше 2^32 - 1 вершин.
+//
+// Float32: координата хранится как float(x - origin.x), погрешность
+//          не больше 2^-24 * |x - origin.x| на координату.
+// Fixed32: координата хранится как int32 round((x - origin.x) / scale),
+//          погрешность не больше scale / 2 на координату; значения вне
+//          диапазона int32 приводят к std::out_of_range.
+//
+// Центр отличается от double-версии не больше чем на погрешность координаты,
+// площадь - примерно на периметр * погрешность координаты.
+class CompactArray {
+public:
+    enum class Encoding { Float32, Fixed32 };
+
+private:
+    Encoding encoding_;
+    Point origin;
+    double scale;
+    std::vector<float> floatCoords;
+    std::vector<int32_t> fixedCoords;
+    std::vector<uint32_t> offsets;
+
+    void checkIndex(int index) const;
+    Point decode(size_t vertex) const;
+
+public:
+    explicit CompactArray(Encoding encoding = Encoding::Float32, Point origin = Point(), double scale = 1e-6);
+
+    void addFigure(const Figure& figure);
+    void addFigures(const Array& array);
+
+    size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    Encoding encoding() const {
+        return encoding_;
+    }
+
+    double maxCoordinateError(double maxDistanceFromOrigin) const;
+
+    size_t vertexCount(int index) const;
+    std::vector<Point> getVertices(int index) const;
+    Point center(int index) const;
+    double area(int index) const;
+    double totalArea() const;
+
+    Figure* createFigure(int index) const;
+    Array toArray() const;
+
+    void clear();
+};
+
+#endif
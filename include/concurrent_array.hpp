@@ -0,0 +1,74 @@
+#ifndef CONCURRENT_ARRAY_H
+#define CONCURRENT_ARRAY_H
+#include "figure.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Коллекция фигур для одновременного чтения и записи.
+// Читатели не берут мьютекс писателей: снимок - это атомарно загруженный
+// shared_ptr на неизменяемую версию. Писатели (по одному за раз) копируют
+// таблицу и публикуют новую версию, поэтому много фигур выгоднее добавлять
+// одним вызовом addFigures. Удаленные фигуры и старые версии хранилища
+// освобождаются, когда их отпускает последний снимок (счетчик ссылок
+// shared_ptr играет роль эпохи).
+class ConcurrentArray {
+private:
+    using Storage = std::vector<std::shared_ptr<const Figure>>;
+
+    std::mutex writeMutex;
+    std::atomic<std::shared_ptr<const Storage>> current;
+
+public:
+    class Snapshot {
+    private:
+        std::shared_ptr<const Storage> figures;
+
+    public:
+        explicit Snapshot(std::shared_ptr<const Storage> figures) : figures(std::move(figures)) {}
+
+        size_t size() const {
+            return figures->size();
+        }
+
+        const Figure* operator[](int index) const;
+        double totalArea() const;
+        void printAllFigures(std::ostream& os) const;
+
+        Storage::const_iterator begin() const {
+            return figures->begin();
+        }
+
+        Storage::const_iterator end() const {
+            return figures->end();
+        }
+    };
+
+    ConcurrentArray();
+
+    ConcurrentArray(const ConcurrentArray& other) = delete;
+    ConcurrentArray& operator=(const ConcurrentArray& other) = delete;
+
+    void addFigure(Figure* figure);
+    // Добавляет все фигуры одной публикацией. Владение всеми фигурами
+    // переходит к массиву сразу: если вызов бросает исключение (например,
+    // среди фигур есть nullptr), ни одна фигура не добавляется и все удаляются.
+    void addFigures(const std::vector<Figure*>& figures);
+    void removeFigure(int index);
+    void clear();
+
+    Snapshot snapshot() const {
+        return Snapshot(current.load(std::memory_order_acquire));
+    }
+
+    size_t size() const {
+        return snapshot().size();
+    }
+
+    double totalArea() const {
+        return snapshot().totalArea();
+    }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef CONTAINMENT_H
+#define CONTAINMENT_H
+#include "figure.hpp"
+#include "array.hpp"
+#include <cstdint>
+
+// Пакетный поиск фигур, содержащих точки.
+// Контуры и ограничивающие прямоугольники фигур строятся один раз при
+// создании индекса; изменения исходного Array после этого не учитываются.
+// Запрос смотрит только фигуры из ячейки равномерной сетки, в которую
+// попала точка: сначала без ветвлений отбираются прямоугольники, затем
+// для отобранных проверяется контур.
+class ContainmentIndex {
+private:
+    std::vector<double> xs, ys;
+    std::vector<uint32_t> offsets;
+
+    // Ячейки сетки в формате CSR: фигуры ячейки c лежат в
+    // [cellStart[c], cellStart[c + 1]) по возрастанию номера, рядом
+    // хранятся копии их прямоугольников
+    BoundingBox bounds{0, 0, 0, 0};
+    size_t columns = 0, rows = 0;
+    double cellWidth = 1, cellHeight = 1;
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellFigures;
+    std::vector<double> cellMinX, cellMinY, cellMaxX, cellMaxY;
+
+    bool outlineContains(size_t figure, double px, double py) const;
+    void queryInto(const Point& point, std::vector<uint8_t>& mask, std::vector<size_t>& hits) const;
+
+public:
+    explicit ContainmentIndex(const Array& array);
+
+    size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    std::vector<size_t> query(const Point& point) const;
+    std::vector<std::vector<size_t>> query(const std::vector<Point>& points) const;
+};
+
+#endif
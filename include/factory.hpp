@@ -0,0 +1,11 @@
+#ifndef FACTORY_H
+#define FACTORY_H
+#include "figure.hpp"
+
+// Создает фигуру по количеству вершин (5, 6 или 8) через Pentagon::create,
+// Hexagon::create или Octagon::create: правильный многоугольник получает
+// параметрическую форму из regular.hpp
+Figure* createFigure(const std::vector<Point>& vertices);
+Figure* createFigure(std::vector<Point>&& vertices);
+
+#endif
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <optional>
+#include <typeindex>
+#include <typeinfo>
 
 struct Point {
     double x, y;
@@ -24,28 +27,120 @@ struct Point {
     }
 };
 
+struct BoundingBox {
+    double minX, minY, maxX, maxY;
+
+    BoundingBox(double minX = 0, double minY = 0, double maxX = 0, double maxY = 0)
+        : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+    bool contains(const Point& p) const {
+        return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+    }
+
+    bool intersects(const BoundingBox& other) const {
+        return minX <= other.maxX && other.minX <= maxX &&
+               minY <= other.maxY && other.minY <= maxY;
+    }
+};
+
+// Память, занимаемая объектом: используемые байты, неиспользуемая емкость
+// буферов и оценка служебных данных аллокатора (заголовок и выравнивание
+// блока кучи, как в glibc malloc)
+struct MemoryUsage {
+    size_t liveBytes = 0;
+    size_t slackBytes = 0;
+    size_t overheadBytes = 0;
+
+    size_t total() const {
+        return liveBytes + slackBytes + overheadBytes;
+    }
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        liveBytes += other.liveBytes;
+        slackBytes += other.slackBytes;
+        overheadBytes += other.overheadBytes;
+        return *this;
+    }
+};
+
+size_t heapBlockOverhead(size_t bytes);
+
+// Правильный многоугольник: вершина k лежит в center + radius *
+// (cos(rotation + 2пk/sides), sin(rotation + 2пk/sides)), обход против часовой.
+// Число сторон не хранится: его знает тип фигуры.
+struct RegularForm {
+    Point center;
+    double radius;
+    double rotation;
+
+    Point vertex(size_t k, size_t sides) const;
+    double area(size_t sides) const;
+
+    // Распознает правильный многоугольник с points.size() сторонами, если
+    // каждая вершина отличается от построенной не больше чем на 1e-9, а на
+    // больших координатах - на несколько единиц младшего разряда double
+    static std::optional<RegularForm> detect(const std::vector<Point>& points);
+};
+
 class Figure {
 protected:
-    std::vector<Point> vertices;
+    // Правильные фигуры (см. regular.hpp) могут строить вершины лениво
+    // в константном getVertices()
+    mutable std::vector<Point> vertices;
+
+    // Вызывается после каждой замены вершин
+    virtual void verticesChanged() {}
+
+    void assignVertices(const Figure& other);
+    void moveVertices(Figure& other);
+    // sides - число вершин фигур этого типа
+    bool sameVertices(const Figure& other, size_t sides) const;
 
 public:
     Figure() = default;
-    Figure(const std::vector<Point>& vertices) : vertices(vertices) {}
-    Figure(std::vector<Point>&& vertices) : vertices(std::move(vertices)) {}
+    Figure(const std::vector<Point>& vertices) { setVertices(vertices); }
+    Figure(std::vector<Point>&& vertices) { setVertices(std::move(vertices)); }
     virtual ~Figure() = default;
     
-    const std::vector<Point>& getVertices() const { 
-        return vertices; 
+    virtual const std::vector<Point>& getVertices() const {
+        return vertices;
+    }
+
+    void setVertices(const std::vector<Point>& newVertices);
+    void setVertices(std::vector<Point>&& newVertices);
+    // Удаляет вершины, сохраняя емкость буфера
+    void clearVertices();
+
+    // Параметрическая форма есть только у правильных фигур из regular.hpp
+    virtual const RegularForm* regularForm() const {
+        return nullptr;
     }
 
-    void setVertices(const std::vector<Point>& newVertices) { 
-        vertices = newVertices; 
+    bool isRegular() const {
+        return regularForm() != nullptr;
     }
 
-    void setVertices(std::vector<Point>&& newVertices) { 
-        vertices = std::move(newVertices); 
+    // Освобождает построенные вершины правильной фигуры
+    virtual void releaseVertexCache() {}
+
+    // Тип для группировки по видам фигур: правильная форма относится
+    // к тому же виду, что и обычная фигура с тем же числом вершин
+    virtual std::type_index figureType() const {
+        return typeid(*this);
     }
     
+    // Размер самого объекта (sizeof динамического типа)
+    virtual size_t objectSize() const {
+        return sizeof(Figure);
+    }
+
+    // Память фигуры, размещенной в куче через new
+    virtual MemoryUsage memoryUsage() const;
+
+    BoundingBox boundingBox() const;
+    bool contains(const Point& p) const;
+    bool overlaps(const Figure& other) const;
+
     virtual Point center() const = 0;
     virtual double area() const;
     virtual void print(std::ostream& os) const = 0;
@@ -62,4 +157,17 @@ public:
 std::ostream& operator<<(std::ostream& os, const Figure& fig);
 std::istream& operator>>(std::istream& is, Figure& fig);
 
+// Контур многоугольника: вершины, упорядоченные по углу вокруг центра масс
+std::vector<Point> polygonOutline(const Point* points, size_t n);
+
+double polygonArea(const Point* points, size_t n);
+
+std::vector<Point> convexHull(const Point* points, size_t n);
+
+// Теорема о разделяющей оси для выпуклых многоугольников (касание - не пересечение)
+bool convexPolygonsOverlap(const std::vector<Point>& a, const std::vector<Point>& b);
+
+// Тест четности пересечений для точки и контура из polygonOutline
+bool outlineContains(const Point* outline, size_t n, const Point& p);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef FIGURE_QUERY_H
+#define FIGURE_QUERY_H
+#include "figure.hpp"
+#include "array.hpp"
+#include <cstdint>
+#include <typeindex>
+
+// Фильтр по коллекции фигур. Тип, площадь, центр и ограничивающий
+// прямоугольник вычисляются один раз при создании в отдельные столбцы,
+// предикаты объединяются по "и" и проверяются без ветвлений по столбцам.
+// Тип хранится однобайтовым номером: больше 255 различных типов в одном
+// массиве приводят к std::length_error.
+class FigureQuery {
+private:
+    enum class Kind { Type, AreaAbove, AreaBelow, CenterIn, Intersects };
+
+    struct Predicate {
+        Kind kind;
+        uint8_t type;
+        double value;
+        BoundingBox box;
+    };
+
+    std::vector<std::type_index> types;
+    std::vector<uint8_t> typeIds;
+    std::vector<double> areas, centerX, centerY;
+    std::vector<double> minX, minY, maxX, maxY;
+    std::vector<Predicate> predicates;
+
+    void apply(const Predicate& predicate, uint8_t* selected, size_t begin, size_t end) const;
+
+public:
+    explicit FigureQuery(const Array& array);
+
+    size_t size() const {
+        return areas.size();
+    }
+
+    // Сравнивается Figure::figureType(): RegularHexagon отбирается как Hexagon
+    template <typename T>
+    FigureQuery& ofType() {
+        return ofType(typeid(T));
+    }
+
+    FigureQuery& ofType(std::type_index type);
+    FigureQuery& areaAbove(double value);
+    FigureQuery& areaBelow(double value);
+    FigureQuery& centerIn(const BoundingBox& box);
+    FigureQuery& intersects(const BoundingBox& box);
+    FigureQuery& reset();
+
+    // 1 для выбранных фигур, 0 для остальных
+    std::vector<uint8_t> selection() const;
+    std::vector<size_t> indices() const;
+    size_t count() const;
+};
+
+#endif
@@ -7,7 +7,18 @@ public:
     Hexagon() = default;
     Hexagon(const std::vector<Point>& vertices);
     Hexagon(std::vector<Point>&& vertices);
+
+    // Конструктор хранит вершины как есть. create распознает правильный
+    // шестиугольник и возвращает RegularHexagon (regular.hpp) без списка вершин
+    static Hexagon* create(const std::vector<Point>& vertices);
+    static Hexagon* create(std::vector<Point>&& vertices);
+    // Правильный шестиугольник по центру, радиусу описанной окружности и повороту
+    static Hexagon* regular(Point center, double radius, double rotation = 0);
     
+    size_t objectSize() const override {
+        return sizeof(Hexagon);
+    }
+
     Point center() const override;
     double area() const override;
     void print(std::ostream& os) const override;
@@ -0,0 +1,76 @@
+#ifndef INTERNED_ARRAY_H
+#define INTERNED_ARRAY_H
+#include "figure.hpp"
+#include "array.hpp"
+#include <cstdint>
+#include <unordered_map>
+
+// Коллекция фигур с общим пулом вершин.
+// Вершины, равные по Point::operator==, хранятся один раз, фигуры хранят
+// 32-битные индексы в пул. Вершина фигуры заменяется первой совпавшей
+// с ней вершиной пула, то есть может сдвинуться меньше чем на 1e-6.
+// Для поиска совпадений при добавлении строится сетка по пулу; после
+// загрузки ее стоит освободить shrink(), иначе она занимает больше памяти,
+// чем экономит пул. Следующее добавление построит сетку заново.
+// Координаты по модулю от 9e12 и NaN не помещаются в сетку: addFigure
+// бросает std::out_of_range и не оставляет части фигуры в коллекции.
+class InternedArray {
+private:
+    struct CellHash {
+        size_t operator()(const std::pair<int64_t, int64_t>& cell) const {
+            return std::hash<int64_t>()(cell.first) * 31 + std::hash<int64_t>()(cell.second);
+        }
+    };
+
+    std::vector<Point> pool;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> offsets;
+    std::unordered_multimap<std::pair<int64_t, int64_t>, uint32_t, CellHash> cells;
+    bool cellsBuilt = false;
+
+    void checkIndex(int index) const;
+    uint32_t intern(const Point& p);
+    void rebuildCells();
+    void dropCells();
+
+public:
+    InternedArray();
+
+    void addFigure(const Figure& figure);
+    void addFigures(const Array& array);
+
+    size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    size_t poolSize() const {
+        return pool.size();
+    }
+
+    size_t vertexCount(int index) const;
+    std::vector<Point> getVertices(int index) const;
+    Point center(int index) const;
+    double area(int index) const;
+    double totalArea() const;
+
+    // Преобразование применяется к каждой вершине пула ровно один раз
+    template <typename Func>
+    void transform(Func func) {
+        for (auto& p : pool) {
+            p = func(p);
+        }
+        dropCells();
+    }
+
+    void translate(double dx, double dy);
+
+    Figure* createFigure(int index) const;
+    Array toArray() const;
+
+    // Освобождает сетку поиска и лишнюю емкость хранилищ
+    void shrink();
+
+    void clear();
+};
+
+#endif
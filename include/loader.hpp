@@ -0,0 +1,23 @@
+#ifndef LOADER_H
+#define LOADER_H
+#include "array.hpp"
+#include <string>
+
+// Текстовый формат набора фигур: одна фигура на строку, имя типа и
+// координаты вершин, например "Pentagon 0 0 1 0 1 1 0.5 1.5 0 1".
+// Пустые строки пропускаются.
+void saveDataset(std::ostream& os, const Array& array);
+
+struct LoadResult {
+    Array figures;
+    std::vector<double> areas;
+    std::vector<Point> centers;
+};
+
+// Загрузка конвейером из трех потоков, связанных очередями ограниченного
+// размера: чтение файла блоками по blockSize байт, разбор строк в фигуры,
+// вычисление площади и центра. Ошибка любой стадии останавливает конвейер
+// и пробрасывается вызывающему.
+LoadResult loadDataset(const std::string& path, size_t blockSize = 1 << 20);
+
+#endif
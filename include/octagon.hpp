@@ -7,7 +7,18 @@ public:
     Octagon() = default;
     Octagon(const std::vector<Point>& vertices);
     Octagon(std::vector<Point>&& vertices);
+
+    // Конструктор хранит вершины как есть. create распознает правильный
+    // восьмиугольник и возвращает RegularOctagon (regular.hpp) без списка вершин
+    static Octagon* create(const std::vector<Point>& vertices);
+    static Octagon* create(std::vector<Point>&& vertices);
+    // Правильный восьмиугольник по центру, радиусу описанной окружности и повороту
+    static Octagon* regular(Point center, double radius, double rotation = 0);
     
+    size_t objectSize() const override {
+        return sizeof(Octagon);
+    }
+
     Point center() const override;
     double area() const override;
     void print(std::ostream& os) const override;
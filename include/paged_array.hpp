@@ -0,0 +1,61 @@
+#ifndef PAGED_ARRAY_H
+#define PAGED_ARRAY_H
+#include "figure.hpp"
+#include "array.hpp"
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Коллекция фигур в файле, разбитом на куски фиксированного размера.
+// В памяти держится не больше cacheChunks кусков (LRU); при
+// последовательном обходе следующий кусок читается заранее в фоне.
+// Файл записывается PagedArray::write в родном порядке байт платформы.
+// Объект не потокобезопасен.
+class PagedArray {
+private:
+    using Chunk = std::vector<std::shared_ptr<const Figure>>;
+    using CacheList = std::list<std::pair<size_t, std::shared_ptr<const Chunk>>>;
+
+    std::string path;
+    size_t count;
+    size_t chunkSize_;
+    size_t cacheChunks;
+
+    mutable CacheList lru;
+    mutable std::unordered_map<size_t, CacheList::iterator> cached;
+    mutable size_t lastChunk;
+    mutable size_t readAheadChunk;
+    mutable std::future<std::shared_ptr<const Chunk>> readAhead;
+
+    // Не обращается к объекту: фоновое чтение не зависит от его адреса,
+    // поэтому PagedArray можно перемещать во время чтения
+    static std::shared_ptr<const Chunk> loadChunk(const std::string& path, size_t count,
+                                                  size_t chunkSize, size_t chunk);
+    std::shared_ptr<const Chunk> getChunk(size_t chunk) const;
+    void insertChunk(size_t chunk, std::shared_ptr<const Chunk> data) const;
+
+public:
+    explicit PagedArray(const std::string& path, size_t cacheChunks = 8);
+
+    static void write(const std::string& path, const Array& array, size_t chunkSize = 4096);
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t chunkSize() const {
+        return chunkSize_;
+    }
+
+    size_t cachedChunks() const {
+        return lru.size();
+    }
+
+    std::shared_ptr<const Figure> operator[](int index) const;
+    double totalArea() const;
+    void printAllFigures(std::ostream& os) const;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Количество кусков, на которые стоит делить n элементов
+inline size_t parallelChunks(size_t n, size_t minChunk) {
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(threads, n / std::max<size_t>(1, minChunk)));
+}
+
+// Вызывает func(chunk, begin, end) для parallelChunks(n, minChunk) кусков,
+// первый кусок выполняется в текущем потоке. func не должна бросать исключений.
+template <typename Func>
+void parallelFor(size_t n, size_t minChunk, Func func) {
+    size_t chunks = parallelChunks(n, minChunk);
+    std::vector<std::thread> threads;
+    for (size_t c = 1; c < chunks; ++c) {
+        threads.emplace_back(func, c, n * c / chunks, n * (c + 1) / chunks);
+    }
+    func(size_t(0), size_t(0), n / chunks);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+#endif
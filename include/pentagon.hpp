@@ -7,7 +7,18 @@ public:
     Pentagon() = default;
     Pentagon(const std::vector<Point>& vertices);
     Pentagon(std::vector<Point>&& vertices);
+
+    // Конструктор хранит вершины как есть. create распознает правильный
+    // пятиугольник и возвращает RegularPentagon (regular.hpp) без списка вершин
+    static Pentagon* create(const std::vector<Point>& vertices);
+    static Pentagon* create(std::vector<Point>&& vertices);
+    // Правильный пятиугольник по центру, радиусу описанной окружности и повороту
+    static Pentagon* regular(Point center, double radius, double rotation = 0);
     
+    size_t objectSize() const override {
+        return sizeof(Pentagon);
+    }
+
     Point center() const override;
     double area() const override;
     void print(std::ostream& os) const override;
@@ -0,0 +1,208 @@
+#ifndef REGULAR_H
+#define REGULAR_H
+#include "figure.hpp"
+#include "pentagon.hpp"
+#include "hexagon.hpp"
+#include "octagon.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+// Фигура, которая хранит правильный многоугольник параметрически
+// (RegularForm) вместо списка вершин. Форма распознается при создании из
+// вершин, setVertices и read; если вершины не образуют правильный
+// многоугольник, фигура ведет себя как Base. Обычные Pentagon/Hexagon/Octagon
+// за форму не платят: она есть только в объектах этого класса. Выбрать тип
+// по вершинам при создании можно через Pentagon::create, Hexagon::create,
+// Octagon::create или createFigure.
+//
+// Вершины строятся при первом getVertices() и кешируются. Построение
+// безопасно при одновременных вызовах константных методов из разных потоков:
+// строит один поток, остальные ждут его.
+template <typename Base, size_t Sides>
+class Regular : public Base {
+private:
+    // PLAIN - формы нет, вершины хранятся как у Base; остальные состояния
+    // описывают кеш вершин при наличии формы
+    enum State { PLAIN, EMPTY, BUILDING, READY };
+
+    RegularForm form{};
+    mutable std::atomic<int> state{PLAIN};
+
+    bool hasForm() const {
+        return state.load(std::memory_order_relaxed) != PLAIN;
+    }
+
+    void setForm(const RegularForm& newForm) {
+        form = newForm;
+        this->vertices.clear();
+        state.store(EMPTY, std::memory_order_relaxed);
+    }
+
+    void dropForm() {
+        state.store(PLAIN, std::memory_order_relaxed);
+    }
+
+    void buildVertices() const {
+        int current = state.load(std::memory_order_acquire);
+        while (current == EMPTY || current == BUILDING) {
+            if (current == EMPTY && state.compare_exchange_weak(current, BUILDING, std::memory_order_acquire)) {
+                try {
+                    this->vertices.reserve(Sides);
+                    for (size_t k = 0; k < Sides; ++k) {
+                        this->vertices.push_back(form.vertex(k, Sides));
+                    }
+                } catch (...) {
+                    this->vertices.clear();
+                    state.store(EMPTY, std::memory_order_release);
+                    throw;
+                }
+                state.store(READY, std::memory_order_release);
+                return;
+            }
+            std::this_thread::yield();
+            current = state.load(std::memory_order_acquire);
+        }
+    }
+
+protected:
+    void verticesChanged() override {
+        auto detected = this->vertices.size() == Sides ? RegularForm::detect(this->vertices) : std::nullopt;
+        if (detected) {
+            setForm(*detected);
+        } else {
+            dropForm();
+        }
+    }
+
+public:
+    Regular() = default;
+
+    Regular(const std::vector<Point>& vertices) : Base(vertices) {
+        verticesChanged();
+    }
+
+    Regular(std::vector<Point>&& vertices) : Base(std::move(vertices)) {
+        verticesChanged();
+    }
+
+    // Центр, радиус описанной окружности и поворот первой вершины
+    Regular(Point center, double radius, double rotation = 0)
+        : Regular(RegularForm{center, radius, rotation}) {}
+
+    explicit Regular(const RegularForm& newForm) {
+        if (!(newForm.radius > 0)) {
+            throw std::invalid_argument("Regular figure radius must be positive");
+        }
+        setForm(newForm);
+    }
+
+    Regular(const Regular& other) : Base() {
+        if (other.hasForm()) {
+            setForm(other.form);
+        } else {
+            this->vertices = other.vertices;
+        }
+    }
+
+    Regular(Regular&& other) noexcept : Base() {
+        if (other.hasForm()) {
+            setForm(other.form);
+        } else {
+            this->vertices = std::move(other.vertices);
+            other.vertices.clear();
+        }
+    }
+
+    Regular& operator=(const Regular& other) {
+        return operator=(static_cast<const Figure&>(other));
+    }
+
+    Regular& operator=(Regular&& other) noexcept {
+        if (this != &other) {
+            if (other.hasForm()) {
+                setForm(other.form);
+            } else {
+                this->vertices = std::move(other.vertices);
+                other.vertices.clear();
+                dropForm();
+            }
+        }
+        return *this;
+    }
+
+    // Форма другой фигуры того же вида переносится без построения вершин
+    Regular& operator=(const Figure& other) override {
+        const RegularForm* otherForm = other.regularForm();
+        if (otherForm && dynamic_cast<const Base*>(&other)) {
+            if (this != &other) setForm(*otherForm);
+        } else {
+            Base::operator=(other);
+        }
+        return *this;
+    }
+
+    Regular& operator=(Figure&& other) override {
+        const RegularForm* otherForm = other.regularForm();
+        if (otherForm && dynamic_cast<const Base*>(&other)) {
+            if (this != &other) setForm(*otherForm);
+        } else {
+            Base::operator=(std::move(other));
+        }
+        return *this;
+    }
+
+    const std::vector<Point>& getVertices() const override {
+        int current = state.load(std::memory_order_acquire);
+        if (current == EMPTY || current == BUILDING) {
+            buildVertices();
+        }
+        return this->vertices;
+    }
+
+    const RegularForm* regularForm() const override {
+        return hasForm() ? &form : nullptr;
+    }
+
+    void releaseVertexCache() override {
+        if (hasForm()) {
+            this->vertices.clear();
+            this->vertices.shrink_to_fit();
+            state.store(EMPTY, std::memory_order_relaxed);
+        }
+    }
+
+    std::type_index figureType() const override {
+        return typeid(Base);
+    }
+
+    size_t objectSize() const override {
+        return sizeof(Regular);
+    }
+
+    // Пока вершины не построены, учитывается только сам объект
+    MemoryUsage memoryUsage() const override {
+        int current = state.load(std::memory_order_acquire);
+        if (current == PLAIN || current == READY) {
+            return Base::memoryUsage();
+        }
+        MemoryUsage usage;
+        usage.liveBytes = objectSize();
+        usage.overheadBytes = heapBlockOverhead(objectSize());
+        return usage;
+    }
+
+    Point center() const override {
+        return hasForm() ? form.center : Base::center();
+    }
+
+    double area() const override {
+        return hasForm() ? form.area(Sides) : Base::area();
+    }
+};
+
+using RegularPentagon = Regular<Pentagon, 5>;
+using RegularHexagon = Regular<Hexagon, 6>;
+using RegularOctagon = Regular<Octagon, 8>;
+
+#endif
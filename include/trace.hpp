@@ -0,0 +1,80 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+// Трассировка в формате Chrome/Perfetto trace-event JSON.
+// Сборка с -DFIGURES_TRACING включает макрос TRACE_SCOPE, без нее он пуст.
+// Во время выполнения запись включается Trace::setEnabled(true); выключенная
+// трассировка стоит одной relaxed-загрузки флага. Каждый поток пишет события
+// в собственный кольцевой буфер, старые события затираются. Буфер защищен
+// своим мьютексом, который у пишущего потока почти всегда свободен: его
+// захватывают только dump, eventCount и reset. Буфер завершившегося потока
+// переиспользуется следующим новым потоком, поэтому tid в выводе - номер
+// буфера, а не системный идентификатор потока.
+class Trace {
+public:
+    static constexpr size_t BUFFER_EVENTS = 1 << 14;
+
+    struct Event {
+        const char* name;
+        int64_t start;
+        int64_t duration;
+    };
+
+    static bool enabled() {
+        return enabledFlag.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool value) {
+        enabledFlag.store(value, std::memory_order_relaxed);
+    }
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void record(const char* name, int64_t start, int64_t end);
+
+    // Можно вызывать одновременно с записью из других потоков
+    static void dump(std::ostream& os);
+    static size_t eventCount();
+    static void reset();
+
+    // Число выделенных буферов потоков
+    static size_t bufferCount();
+
+private:
+    static std::atomic<bool> enabledFlag;
+};
+
+class TraceScope {
+private:
+    const char* name;
+    int64_t start;
+
+public:
+    explicit TraceScope(const char* scopeName)
+        : name(Trace::enabled() ? scopeName : nullptr), start(name ? Trace::now() : 0) {}
+
+    ~TraceScope() {
+        if (name) Trace::record(name, start, Trace::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifdef FIGURES_TRACING
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif
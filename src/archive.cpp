@@ -0,0 +1,188 @@
+#include "../include/archive.hpp"
+#include "../include/factory.hpp"
+#include "../include/parallel.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+const char MAGIC[4] = {'F', 'I', 'G', 'Z'};
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos == end) return false;
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int64_t quantize(double value) {
+    double q = std::round(value / Archive::QUANTUM);
+    if (!(std::abs(q) < 4e18)) {
+        throw std::out_of_range("Coordinate is out of archive range");
+    }
+    return static_cast<int64_t>(q);
+}
+
+template <typename T>
+void writeRaw(std::ostream& os, T value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readRaw(std::istream& is, T& value) {
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+struct Block {
+    uint32_t figures = 0;
+    std::vector<uint8_t> bytes;
+};
+
+std::vector<std::unique_ptr<Figure>> decodeBlock(const Block& block) {
+    std::vector<std::unique_ptr<Figure>> result;
+    result.reserve(block.figures);
+
+    const uint8_t* pos = block.bytes.data();
+    const uint8_t* end = pos + block.bytes.size();
+    for (uint32_t f = 0; f < block.figures; ++f) {
+        uint64_t n;
+        if (!getVarint(pos, end, n) || n > block.bytes.size()) {
+            throw std::runtime_error("Corrupted archive block");
+        }
+
+        std::vector<Point> verts;
+        verts.reserve(n);
+        int64_t x = 0, y = 0;
+        for (uint64_t k = 0; k < n; ++k) {
+            uint64_t dx, dy;
+            if (!getVarint(pos, end, dx) || !getVarint(pos, end, dy)) {
+                throw std::runtime_error("Corrupted archive block");
+            }
+            x += unzigzag(dx);
+            y += unzigzag(dy);
+            verts.push_back(Point(x * Archive::QUANTUM, y * Archive::QUANTUM));
+        }
+        result.emplace_back(createFigure(std::move(verts)));
+    }
+    if (pos != end) {
+        throw std::runtime_error("Corrupted archive block");
+    }
+    return result;
+}
+
+}
+
+void Archive::write(std::ostream& os, const Array& array, size_t blockSize) {
+    if (blockSize == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+
+    uint64_t blockCount = (array.size() + blockSize - 1) / blockSize;
+    os.write(MAGIC, sizeof(MAGIC));
+    writeRaw<uint64_t>(os, array.size());
+    writeRaw<uint64_t>(os, blockCount);
+
+    std::vector<uint8_t> bytes;
+    for (size_t first = 0; first < array.size(); first += blockSize) {
+        size_t last = std::min(array.size(), first + blockSize);
+        bytes.clear();
+
+        for (size_t i = first; i < last; ++i) {
+            const auto& verts = array.get(i)->getVertices();
+            putVarint(bytes, verts.size());
+
+            int64_t x = 0, y = 0;
+            for (const auto& p : verts) {
+                int64_t qx = quantize(p.x), qy = quantize(p.y);
+                putVarint(bytes, zigzag(qx - x));
+                putVarint(bytes, zigzag(qy - y));
+                x = qx;
+                y = qy;
+            }
+        }
+
+        writeRaw<uint32_t>(os, static_cast<uint32_t>(last - first));
+        writeRaw<uint32_t>(os, static_cast<uint32_t>(bytes.size()));
+        os.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    if (!os) {
+        throw std::runtime_error("Failed to write archive");
+    }
+}
+
+Array Archive::read(std::istream& is) {
+    char magic[sizeof(MAGIC)];
+    uint64_t figureCount, blockCount;
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !readRaw(is, figureCount) || !readRaw(is, blockCount)) {
+        throw std::runtime_error("Invalid archive header");
+    }
+
+    std::vector<Block> blocks;
+    uint64_t total = 0;
+    for (uint64_t b = 0; b < blockCount; ++b) {
+        Block block;
+        uint32_t length;
+        if (!readRaw(is, block.figures) || !readRaw(is, length)) {
+            throw std::runtime_error("Truncated archive");
+        }
+        block.bytes.resize(length);
+        if (!is.read(reinterpret_cast<char*>(block.bytes.data()), length)) {
+            throw std::runtime_error("Truncated archive");
+        }
+        total += block.figures;
+        blocks.push_back(std::move(block));
+    }
+    if (total != figureCount) {
+        throw std::runtime_error("Archive figure count mismatch");
+    }
+
+    std::vector<std::vector<std::unique_ptr<Figure>>> decoded(blocks.size());
+    std::vector<std::exception_ptr> errors(blocks.size());
+    parallelFor(blocks.size(), 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            try {
+                decoded[b] = decodeBlock(blocks[b]);
+            } catch (...) {
+                errors[b] = std::current_exception();
+            }
+        }
+    });
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    Array result;
+    for (auto& block : decoded) {
+        for (auto& figure : block) {
+            result.addFigure(figure.get());
+            figure.release();
+        }
+    }
+    return result;
+}
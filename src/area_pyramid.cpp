@@ -0,0 +1,223 @@
+#include "../include/area_pyramid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Наименьший размер списка вне bounds, при котором bounds перестраиваются
+const size_t REBUILD_MIN = 64;
+
+BoundingBox centerBounds(const Array& array) {
+    if (array.size() == 0) return BoundingBox(0, 0, 1, 1);
+
+    Point first = array.get(0)->center();
+    BoundingBox box(first.x, first.y, first.x, first.y);
+    for (const Figure* figure : array) {
+        Point c = figure->center();
+        box.minX = std::min(box.minX, c.x);
+        box.minY = std::min(box.minY, c.y);
+        box.maxX = std::max(box.maxX, c.x);
+        box.maxY = std::max(box.maxY, c.y);
+    }
+    if (box.maxX - box.minX <= 0) box.maxX = box.minX + 1;
+    if (box.maxY - box.minY <= 0) box.maxY = box.minY + 1;
+    return box;
+}
+
+}
+
+AreaPyramid::AreaPyramid(const BoundingBox& bounds, size_t depth)
+    : bounds(bounds), depth(depth), rebuildAt(REBUILD_MIN) {
+    if (!(bounds.maxX > bounds.minX) || !(bounds.maxY > bounds.minY)) {
+        throw std::invalid_argument("Pyramid bounds must have positive size");
+    }
+    if (depth > 12) {
+        throw std::invalid_argument("Pyramid depth is too large");
+    }
+
+    for (size_t level = 0; level <= depth; ++level) {
+        size_t side = size_t(1) << level;
+        levels.emplace_back(side * side);
+    }
+    leaves.resize(levels.back().size());
+}
+
+AreaPyramid::AreaPyramid(const Array& array, size_t depth) : AreaPyramid(centerBounds(array), depth) {
+    for (const Figure* figure : array) {
+        add(figure);
+    }
+}
+
+std::shared_ptr<AreaPyramid> AreaPyramid::attach(Array& array, size_t depth) {
+    auto pyramid = std::make_shared<AreaPyramid>(array, depth);
+    array.setObserver(pyramid);
+    return pyramid;
+}
+
+size_t AreaPyramid::leafOf(const Point& center) const {
+    if (!bounds.contains(center)) return OUTSIDE;
+
+    size_t side = size_t(1) << depth;
+    auto cell = [side](double value, double min, double max) {
+        size_t index = static_cast<size_t>((value - min) / (max - min) * side);
+        return std::min(index, side - 1);
+    };
+    return cell(center.y, bounds.minY, bounds.maxY) * side + cell(center.x, bounds.minX, bounds.maxX);
+}
+
+void AreaPyramid::update(size_t leaf, double area, int delta) {
+    size_t x = leaf % (size_t(1) << depth);
+    size_t y = leaf / (size_t(1) << depth);
+    for (size_t level = depth + 1; level-- > 0;) {
+        RegionTotal& cell = levels[level][(y << level) + x];
+        cell.count += delta;
+        cell.area = cell.count == 0 ? 0 : cell.area + delta * area;
+        x >>= 1;
+        y >>= 1;
+    }
+}
+
+void AreaPyramid::place(const Figure* figure, Entry entry) {
+    entry.leaf = leafOf(entry.center);
+    auto& list = entry.leaf == OUTSIDE ? outside : leaves[entry.leaf];
+    list.push_back(figure);
+    try {
+        entries.emplace(figure, entry);
+    } catch (...) {
+        list.pop_back();
+        throw;
+    }
+    if (entry.leaf != OUTSIDE) {
+        update(entry.leaf, entry.area, 1);
+    }
+}
+
+// Новые bounds охватывают конечные центры всех фигур и pending. Пирамида
+// строится заново рядом и заменяет текущую, только если построение удалось.
+void AreaPyramid::rebuildBounds(const Point& pending) {
+    BoundingBox box(pending.x, pending.y, pending.x, pending.y);
+    bool found = std::isfinite(pending.x) && std::isfinite(pending.y);
+    for (const auto& item : entries) {
+        const Point& c = item.second.center;
+        if (!std::isfinite(c.x) || !std::isfinite(c.y)) continue;
+        if (!found) {
+            box = BoundingBox(c.x, c.y, c.x, c.y);
+            found = true;
+        }
+        box.minX = std::min(box.minX, c.x);
+        box.minY = std::min(box.minY, c.y);
+        box.maxX = std::max(box.maxX, c.x);
+        box.maxY = std::max(box.maxY, c.y);
+    }
+    if (found && std::isfinite(box.maxX - box.minX) && std::isfinite(box.maxY - box.minY)) {
+        if (box.maxX - box.minX <= 0) box.maxX = box.minX + 1;
+        if (box.maxY - box.minY <= 0) box.maxY = box.minY + 1;
+
+        AreaPyramid rebuilt(box, depth);
+        rebuilt.entries.reserve(entries.size() + 1);
+        for (const auto& item : entries) {
+            rebuilt.place(item.first, item.second);
+        }
+        bounds = rebuilt.bounds;
+        levels = std::move(rebuilt.levels);
+        leaves = std::move(rebuilt.leaves);
+        outside = std::move(rebuilt.outside);
+        entries = std::move(rebuilt.entries);
+    }
+    // Следующая перестройка - после заметного числа новых фигур вне bounds
+    rebuildAt = std::max({REBUILD_MIN, 2 * outside.size(), entries.size() / 4});
+}
+
+void AreaPyramid::add(const Figure* figure) {
+    if (figure == nullptr) {
+        throw std::invalid_argument("Cannot add null figure");
+    }
+    if (entries.count(figure)) {
+        throw std::invalid_argument("Figure is already in the pyramid");
+    }
+
+    Entry entry{figure->center(), figure->area(), 0};
+    if (!bounds.contains(entry.center) && outside.size() + 1 >= rebuildAt) {
+        rebuildBounds(entry.center);
+    }
+    place(figure, entry);
+}
+
+void AreaPyramid::remove(const Figure* figure) {
+    auto it = entries.find(figure);
+    if (it == entries.end()) {
+        throw std::invalid_argument("Figure is not in the pyramid");
+    }
+
+    const Entry& entry = it->second;
+    auto& list = entry.leaf == OUTSIDE ? outside : leaves[entry.leaf];
+    auto pos = std::find(list.begin(), list.end(), figure);
+    *pos = list.back();
+    list.pop_back();
+    if (entry.leaf != OUTSIDE) {
+        update(entry.leaf, entry.area, -1);
+    }
+    entries.erase(it);
+}
+
+void AreaPyramid::clear() noexcept {
+    for (auto& level : levels) {
+        std::fill(level.begin(), level.end(), RegionTotal());
+    }
+    for (auto& leaf : leaves) {
+        leaf.clear();
+    }
+    outside.clear();
+    entries.clear();
+    rebuildAt = REBUILD_MIN;
+}
+
+void AreaPyramid::collectExact(const std::vector<const Figure*>& figures, const BoundingBox& region,
+                               RegionTotal& total) const {
+    for (const Figure* figure : figures) {
+        const Entry& entry = entries.at(figure);
+        if (region.contains(entry.center)) {
+            total.count++;
+            total.area += entry.area;
+        }
+    }
+}
+
+void AreaPyramid::collect(size_t level, size_t cx, size_t cy, const BoundingBox& region, RegionTotal& total) const {
+    size_t side = size_t(1) << level;
+    const RegionTotal& cell = levels[level][cy * side + cx];
+    if (cell.count == 0) return;
+
+    double width = (bounds.maxX - bounds.minX) / side;
+    double height = (bounds.maxY - bounds.minY) / side;
+    BoundingBox rect(bounds.minX + cx * width, bounds.minY + cy * height,
+                     bounds.minX + (cx + 1) * width, bounds.minY + (cy + 1) * height);
+    if (!rect.intersects(region)) return;
+
+    // Запас на округление при отнесении центра к ячейке
+    double margin = 1e-9 * std::max(width, height);
+    if (region.minX <= rect.minX - margin && rect.maxX + margin <= region.maxX &&
+        region.minY <= rect.minY - margin && rect.maxY + margin <= region.maxY) {
+        total.count += cell.count;
+        total.area += cell.area;
+        return;
+    }
+
+    if (level == depth) {
+        collectExact(leaves[cy * side + cx], region, total);
+        return;
+    }
+    for (size_t dy = 0; dy < 2; ++dy) {
+        for (size_t dx = 0; dx < 2; ++dx) {
+            collect(level + 1, 2 * cx + dx, 2 * cy + dy, region, total);
+        }
+    }
+}
+
+AreaPyramid::RegionTotal AreaPyramid::query(const BoundingBox& region) const {
+    RegionTotal total;
+    collect(0, 0, 0, region, total);
+    collectExact(outside, region, total);
+    return total;
+}
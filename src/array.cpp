@@ -1,14 +1,21 @@
 #include "../include/array.hpp"
+#include "../include/parallel.hpp"
+#include "../include/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <queue>
 #include <stdexcept>
 #include <iostream>
 
-Array::Array() : figures(nullptr), capacity(0), size_(0) {}
+Array::Array() : figures(nullptr), capacity(0), size_(0), poolLimit(DEFAULT_POOL_LIMIT) {}
 
 Array::~Array() {
     clear();
 }
 
 void Array::resize() {
+    TRACE_SCOPE("Array::resize");
     size_t newCapacity = (capacity == 0) ? 2 : capacity * 2;
     Figure** newFigures = new Figure*[newCapacity];
     
@@ -23,6 +30,7 @@ void Array::resize() {
 }
 
 void Array::addFigure(Figure* figure) {
+    TRACE_SCOPE("Array::addFigure");
     if (figure == nullptr) {
         throw std::invalid_argument("Cannot add null figure");
     }
@@ -30,6 +38,9 @@ void Array::addFigure(Figure* figure) {
     if (size_ >= capacity) {
         resize();
     }
+    if (observer) {
+        observer->figureAdded(figure);
+    }
     
     figures[size_] = figure;
     size_++;
@@ -40,7 +51,27 @@ void Array::removeFigure(int index) {
         throw std::out_of_range("Index out of range");
     }
     
-    delete figures[index];
+    // Место в пуле готовится до уведомления: если что-то бросит
+    // исключение, массив и наблюдатель останутся согласованы
+    Figure* removed = figures[index];
+    std::vector<Figure*>* parked = nullptr;
+    if (poolLimit > 0) {
+        auto& list = pool[typeid(*removed)];
+        if (list.size() < poolLimit) {
+            if (list.size() == list.capacity()) {
+                list.reserve(std::min(poolLimit, std::max<size_t>(4, 2 * list.size())));
+            }
+            parked = &list;
+        }
+    }
+    if (observer) {
+        observer->figureRemoved(removed);
+    }
+    if (parked) {
+        parked->push_back(removed);
+    } else {
+        delete removed;
+    }
     
     for (size_t i = index; i < size_ - 1; ++i) {
         figures[i] = figures[i + 1];
@@ -51,6 +82,7 @@ void Array::removeFigure(int index) {
 }
 
 double Array::totalArea() const {
+    TRACE_SCOPE("Array::totalArea");
     double total = 0;
     for (size_t i = 0; i < size_; ++i) {
         total += figures[i]->area();
@@ -59,9 +91,162 @@ double Array::totalArea() const {
 }
 
 void Array::printAllFigures(std::ostream& os) const {
+    TRACE_SCOPE("Array::printAllFigures");
     for (size_t i = 0; i < size_; ++i) {
-        os << "Figure " << i << ": " << *figures[i] << std::endl;
+        os << "Figure " << i << ": " << *figures[i] << '\n';
+    }
+}
+
+std::vector<std::pair<size_t, size_t>> Array::findOverlappingPairs() const {
+    std::vector<BoundingBox> boxes(size_);
+    std::vector<std::vector<Point>> hulls(size_);
+    parallelFor(size_, 1024, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& verts = figures[i]->getVertices();
+            boxes[i] = figures[i]->boundingBox();
+            hulls[i] = convexHull(verts.data(), verts.size());
+        }
+    });
+
+    // Широкая фаза: проход по оси X. Порядок по minX делится на куски,
+    // каждый кусок обходится в своем потоке. Активные прямоугольники лежат
+    // в куче по maxX; кусок начинает с тех прямоугольников из предыдущих
+    // кусков, которые еще перекрывают его по X. Пара учитывается тем
+    // элементом, который стоит позже в порядке обхода.
+    std::vector<size_t> order(size_);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return boxes[a].minX < boxes[b].minX;
+    });
+
+    auto laterMaxX = [&](size_t a, size_t b) {
+        return boxes[a].maxX > boxes[b].maxX;
+    };
+
+    // Узкая фаза выполняется сразу: точная проверка по разделяющей оси
+    size_t chunks = parallelChunks(size_, 1024);
+    std::vector<std::vector<std::pair<size_t, size_t>>> partial(chunks);
+    parallelFor(size_, 1024, [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<size_t> active;
+        if (begin < end) {
+            double firstMinX = boxes[order[begin]].minX;
+            for (size_t k = 0; k < begin; ++k) {
+                if (boxes[order[k]].maxX >= firstMinX) {
+                    active.push_back(order[k]);
+                }
+            }
+            std::make_heap(active.begin(), active.end(), laterMaxX);
+        }
+
+        for (size_t k = begin; k < end; ++k) {
+            size_t i = order[k];
+            while (!active.empty() && boxes[active.front()].maxX < boxes[i].minX) {
+                std::pop_heap(active.begin(), active.end(), laterMaxX);
+                active.pop_back();
+            }
+
+            for (size_t j : active) {
+                if (boxes[i].intersects(boxes[j]) && convexPolygonsOverlap(hulls[i], hulls[j])) {
+                    partial[chunk].emplace_back(std::min(i, j), std::max(i, j));
+                }
+            }
+            active.push_back(i);
+            std::push_heap(active.begin(), active.end(), laterMaxX);
+        }
+    });
+
+    std::vector<std::pair<size_t, size_t>> result;
+    for (const auto& part : partial) {
+        result.insert(result.end(), part.begin(), part.end());
     }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<double> Array::metricColumn(Metric metric) const {
+    std::vector<double> column(size_);
+    parallelFor(size_, 4096, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            switch (metric) {
+                case Metric::Area: column[i] = figures[i]->area(); break;
+                case Metric::CenterX: column[i] = figures[i]->center().x; break;
+                case Metric::CenterY: column[i] = figures[i]->center().y; break;
+                case Metric::VertexCount: column[i] = static_cast<double>(figures[i]->getVertices().size()); break;
+            }
+        }
+    });
+    return column;
+}
+
+void Array::sortBy(Metric metric, bool descending) {
+    std::vector<double> column = metricColumn(metric);
+    std::vector<std::pair<double, size_t>> keys(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        keys[i] = {descending ? -column[i] : column[i], i};
+    }
+
+    // Куски сортируются параллельно и затем сливаются
+    size_t chunks = parallelChunks(size_, 16384);
+    parallelFor(size_, 16384, [&](size_t, size_t begin, size_t end) {
+        std::sort(keys.begin() + begin, keys.begin() + end);
+    });
+    for (size_t width = 1; width < chunks; width *= 2) {
+        for (size_t c = 0; c + width < chunks; c += 2 * width) {
+            auto first = keys.begin() + size_ * c / chunks;
+            auto middle = keys.begin() + size_ * (c + width) / chunks;
+            auto last = keys.begin() + size_ * std::min(chunks, c + 2 * width) / chunks;
+            std::inplace_merge(first, middle, last);
+        }
+    }
+
+    std::vector<Figure*> sorted(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        sorted[i] = figures[keys[i].second];
+    }
+    std::copy(sorted.begin(), sorted.end(), figures);
+}
+
+std::vector<size_t> Array::topK(Metric metric, size_t k) const {
+    std::vector<double> column = metricColumn(metric);
+    k = std::min(k, size_);
+
+    // Больший ключ лучше, при равенстве - меньший индекс
+    using Entry = std::pair<double, size_t>;
+    auto better = [](const Entry& a, const Entry& b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    };
+    using Heap = std::priority_queue<Entry, std::vector<Entry>, decltype(better)>;
+
+    size_t chunks = parallelChunks(size_, 16384);
+    std::vector<std::vector<Entry>> partial(chunks);
+    parallelFor(size_, 16384, [&](size_t chunk, size_t begin, size_t end) {
+        Heap heap(better);
+        for (size_t i = begin; i < end && k > 0; ++i) {
+            Entry entry(column[i], i);
+            if (heap.size() < k) {
+                heap.push(entry);
+            } else if (better(entry, heap.top())) {
+                heap.pop();
+                heap.push(entry);
+            }
+        }
+        while (!heap.empty()) {
+            partial[chunk].push_back(heap.top());
+            heap.pop();
+        }
+    });
+
+    std::vector<Entry> merged;
+    for (const auto& part : partial) {
+        merged.insert(merged.end(), part.begin(), part.end());
+    }
+    std::partial_sort(merged.begin(), merged.begin() + k, merged.end(), better);
+
+    std::vector<size_t> result(k);
+    for (size_t i = 0; i < k; ++i) {
+        result[i] = merged[i].second;
+    }
+    return result;
 }
 
 Figure* Array::operator[](int index) const {
@@ -80,13 +265,157 @@ void Array::clear() {
     figures = nullptr;
     capacity = 0;
     size_ = 0;
+
+    releasePool();
+    if (observer) {
+        observer->cleared();
+    }
+}
+
+void Array::releasePool() {
+    for (auto& entry : pool) {
+        for (Figure* figure : entry.second) {
+            delete figure;
+        }
+    }
+    pool.clear();
+}
+
+ArrayMemoryUsage Array::memoryUsage() const {
+    ArrayMemoryUsage usage;
+    usage.storage.liveBytes = size_ * sizeof(Figure*);
+    usage.storage.slackBytes = (capacity - size_) * sizeof(Figure*);
+    if (capacity > 0) {
+        usage.storage.overheadBytes = heapBlockOverhead(capacity * sizeof(Figure*));
+    }
+    usage.total += usage.storage;
+
+    for (size_t i = 0; i < size_; ++i) {
+        MemoryUsage figure = figures[i]->memoryUsage();
+        std::type_index type = typeid(*figures[i]);
+        usage.byType[type] += figure;
+        usage.countByType[type]++;
+        usage.total += figure;
+    }
+
+    for (const auto& entry : pool) {
+        const auto& list = entry.second;
+        usage.pool.slackBytes += list.capacity() * sizeof(Figure*);
+        if (list.capacity() > 0) {
+            usage.pool.overheadBytes += heapBlockOverhead(list.capacity() * sizeof(Figure*));
+        }
+        // Фигуры в пуле не используются: их память считается запасом
+        for (const Figure* figure : list) {
+            MemoryUsage parked = figure->memoryUsage();
+            usage.pool.slackBytes += parked.liveBytes + parked.slackBytes;
+            usage.pool.overheadBytes += parked.overheadBytes;
+        }
+    }
+    usage.total += usage.pool;
+    return usage;
+}
+
+std::unordered_map<std::type_index, TypeSummary> Array::aggregateByType(double binWidth, size_t binCount) const {
+    if (!(binWidth > 0) || binCount == 0) {
+        throw std::invalid_argument("Histogram needs positive bin width and count");
+    }
+
+    // Частичные результаты потоков сливаются после прохода
+    using Partial = std::unordered_map<std::type_index, TypeSummary>;
+    std::vector<Partial> partial(parallelChunks(size_, 4096));
+    std::atomic<bool> invalidArea{false};
+    parallelFor(size_, 4096, [&](size_t chunk, size_t begin, size_t end) {
+        Partial& local = partial[chunk];
+        for (size_t i = begin; i < end; ++i) {
+            TypeSummary& summary = local[figures[i]->figureType()];
+            if (summary.histogram.empty()) {
+                summary.histogram.assign(binCount, 0);
+            }
+
+            double area = figures[i]->area();
+            if (std::isnan(area)) {
+                invalidArea.store(true, std::memory_order_relaxed);
+                continue;
+            }
+            Point c = figures[i]->center();
+            // Ограничение в double до приведения: частное может не поместиться в size_t
+            size_t bin = static_cast<size_t>(std::clamp<double>(area / binWidth, 0, binCount - 1));
+            summary.count++;
+            summary.totalArea += area;
+            summary.histogram[bin]++;
+            summary.centroid.x += c.x;
+            summary.centroid.y += c.y;
+        }
+    });
+    if (invalidArea.load()) {
+        throw std::invalid_argument("Figure area is not a number");
+    }
+
+    Partial result;
+    for (const auto& local : partial) {
+        for (const auto& entry : local) {
+            TypeSummary& summary = result[entry.first];
+            if (summary.histogram.empty()) {
+                summary.histogram.assign(binCount, 0);
+            }
+            summary.count += entry.second.count;
+            summary.totalArea += entry.second.totalArea;
+            summary.centroid.x += entry.second.centroid.x;
+            summary.centroid.y += entry.second.centroid.y;
+            for (size_t b = 0; b < binCount; ++b) {
+                summary.histogram[b] += entry.second.histogram[b];
+            }
+        }
+    }
+
+    for (auto& entry : result) {
+        TypeSummary& summary = entry.second;
+        summary.meanArea = summary.totalArea / summary.count;
+        summary.centroid = Point(summary.centroid.x / summary.count, summary.centroid.y / summary.count);
+    }
+    return result;
+}
+
+size_t Array::regularCount() const {
+    size_t count = 0;
+    for (size_t i = 0; i < size_; ++i) {
+        count += figures[i]->isRegular();
+    }
+    return count;
+}
+
+void Array::releaseVertexCaches() {
+    for (size_t i = 0; i < size_; ++i) {
+        figures[i]->releaseVertexCache();
+    }
+}
+
+void Array::setPoolLimit(size_t limit) {
+    poolLimit = limit;
+    for (auto& entry : pool) {
+        auto& list = entry.second;
+        while (list.size() > poolLimit) {
+            delete list.back();
+            list.pop_back();
+        }
+    }
+}
+
+size_t Array::pooledCount() const {
+    size_t count = 0;
+    for (const auto& entry : pool) {
+        count += entry.second.size();
+    }
+    return count;
 }
 
 Array::Array(Array&& other) noexcept 
-    : figures(other.figures), capacity(other.capacity), size_(other.size_) {
+    : figures(other.figures), capacity(other.capacity), size_(other.size_), pool(std::move(other.pool)), poolLimit(other.poolLimit),
+      observer(std::move(other.observer)) {
     other.figures = nullptr;
     other.capacity = 0;
     other.size_ = 0;
+    other.pool.clear();
 }
 
 Array& Array::operator=(Array&& other) noexcept {
@@ -96,10 +425,14 @@ Array& Array::operator=(Array&& other) noexcept {
         figures = other.figures;
         capacity = other.capacity;
         size_ = other.size_;
+        pool = std::move(other.pool);
+        poolLimit = other.poolLimit;
+        observer = std::move(other.observer);
         
         other.figures = nullptr;
         other.capacity = 0;
         other.size_ = 0;
+        other.pool.clear();
     }
     return *this;
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "../include/array_diff.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <typeindex>
+#include <unordered_map>
+
+namespace {
+
+const double CELL = 1e-6;
+
+// Ячейка центра с допуском Point::operator== и тип фигуры: фигуры разных
+// типов не равны, поэтому в один бакет не попадают
+struct Key {
+    int64_t x;
+    int64_t y;
+    std::type_index type;
+
+    bool operator==(const Key& other) const {
+        return x == other.x && y == other.y && type == other.type;
+    }
+};
+
+struct KeyHash {
+    size_t operator()(const Key& key) const {
+        return (std::hash<int64_t>()(key.x) * 31 + std::hash<int64_t>()(key.y)) * 31 + key.type.hash_code();
+    }
+};
+
+// Равные фигуры бакета: индексы по возрастанию, head - первый
+// несопоставленный. Совпадения выбираются по порядку, поэтому дубликаты
+// сопоставляются за O(1) каждый.
+struct Group {
+    std::vector<size_t> items;
+    size_t head = 0;
+};
+
+// Номер ячейки должен помещаться в int64_t; NaN не проходит проверку
+bool cellIndex(double value, int64_t& index) {
+    double cell = std::floor(value / CELL);
+    if (!(std::abs(cell) < 9e18)) return false;
+    index = static_cast<int64_t>(cell);
+    return true;
+}
+
+std::vector<Key> figureKeys(const Array& array) {
+    std::vector<Key> keys(array.size(), Key{0, 0, typeid(void)});
+    std::atomic<bool> valid{true};
+    parallelFor(array.size(), 4096, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Figure* figure = array.get(i);
+            Point c = figure->center();
+            Key& key = keys[i];
+            key.type = figure->figureType();
+            if (!cellIndex(c.x, key.x) || !cellIndex(c.y, key.y)) {
+                valid.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+    if (!valid.load()) {
+        throw std::out_of_range("Figure center cannot be compared");
+    }
+    return keys;
+}
+
+}
+
+ArrayDiff diff(const Array& before, const Array& after) {
+    std::vector<Key> beforeKeys = figureKeys(before);
+    std::vector<Key> afterKeys = figureKeys(after);
+
+    std::unordered_map<Key, std::vector<Group>, KeyHash> buckets;
+    buckets.reserve(before.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        std::vector<Group>& groups = buckets[beforeKeys[i]];
+        const Figure& figure = *before.get(i);
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) {
+            return *before.get(g.items.front()) == figure;
+        });
+        if (group == groups.end()) {
+            groups.emplace_back();
+            group = groups.end() - 1;
+        }
+        group->items.push_back(i);
+    }
+
+    ArrayDiff result;
+    std::vector<bool> matched(before.size(), false);
+    for (size_t j = 0; j < after.size(); ++j) {
+        const Figure& figure = *after.get(j);
+        Group* best = nullptr;
+
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            for (int64_t dy = -1; dy <= 1; ++dy) {
+                auto it = buckets.find(Key{afterKeys[j].x + dx, afterKeys[j].y + dy, afterKeys[j].type});
+                if (it == buckets.end()) continue;
+                for (Group& group : it->second) {
+                    if (group.head == group.items.size()) continue;
+                    if (best && best->items[best->head] < group.items[group.head]) continue;
+                    if (*before.get(group.items[group.head]) == figure) {
+                        best = &group;
+                    }
+                }
+            }
+        }
+
+        if (!best) {
+            result.added.push_back(j);
+        } else {
+            size_t i = best->items[best->head++];
+            matched[i] = true;
+            result.unchanged.emplace_back(i, j);
+        }
+    }
+
+    for (size_t i = 0; i < before.size(); ++i) {
+        if (!matched[i]) result.removed.push_back(i);
+    }
+    return result;
+}
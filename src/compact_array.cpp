@@ -0,0 +1,128 @@
+#include "../include/compact_array.hpp"
+#include "../include/factory.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+CompactArray::CompactArray(Encoding encoding, Point origin, double scale)
+    : encoding_(encoding), origin(origin), scale(scale), offsets{0} {
+    if (encoding == Encoding::Fixed32 && !(scale > 0)) {
+        throw std::invalid_argument("Fixed-point scale must be positive");
+    }
+}
+
+void CompactArray::checkIndex(int index) const {
+    if (index < 0 || index >= static_cast<int>(size())) {
+        throw std::out_of_range("Index out of range");
+    }
+}
+
+Point CompactArray::decode(size_t vertex) const {
+    if (encoding_ == Encoding::Float32) {
+        return Point(origin.x + floatCoords[2 * vertex], origin.y + floatCoords[2 * vertex + 1]);
+    }
+    return Point(origin.x + fixedCoords[2 * vertex] * scale, origin.y + fixedCoords[2 * vertex + 1] * scale);
+}
+
+void CompactArray::addFigure(const Figure& figure) {
+    const auto& verts = figure.getVertices();
+    if (verts.size() > std::numeric_limits<uint32_t>::max() - offsets.back()) {
+        throw std::length_error("Compact vertex storage is full");
+    }
+
+    if (encoding_ == Encoding::Float32) {
+        for (const auto& p : verts) {
+            floatCoords.push_back(static_cast<float>(p.x - origin.x));
+            floatCoords.push_back(static_cast<float>(p.y - origin.y));
+        }
+    } else {
+        const double limit = std::numeric_limits<int32_t>::max();
+        std::vector<int32_t> encoded;
+        encoded.reserve(2 * verts.size());
+        for (const auto& p : verts) {
+            for (double value : {(p.x - origin.x) / scale, (p.y - origin.y) / scale}) {
+                double rounded = std::round(value);
+                if (!(std::abs(rounded) <= limit)) {
+                    throw std::out_of_range("Coordinate does not fit fixed-point range");
+                }
+                encoded.push_back(static_cast<int32_t>(rounded));
+            }
+        }
+        fixedCoords.insert(fixedCoords.end(), encoded.begin(), encoded.end());
+    }
+
+    offsets.push_back(offsets.back() + static_cast<uint32_t>(verts.size()));
+}
+
+void CompactArray::addFigures(const Array& array) {
+    for (const Figure* figure : array) {
+        addFigure(*figure);
+    }
+}
+
+double CompactArray::maxCoordinateError(double maxDistanceFromOrigin) const {
+    if (encoding_ == Encoding::Float32) {
+        return std::ldexp(maxDistanceFromOrigin, -24);
+    }
+    return scale / 2;
+}
+
+size_t CompactArray::vertexCount(int index) const {
+    checkIndex(index);
+    return offsets[index + 1] - offsets[index];
+}
+
+std::vector<Point> CompactArray::getVertices(int index) const {
+    checkIndex(index);
+    std::vector<Point> result;
+    result.reserve(offsets[index + 1] - offsets[index]);
+    for (size_t v = offsets[index]; v < offsets[index + 1]; ++v) {
+        result.push_back(decode(v));
+    }
+    return result;
+}
+
+Point CompactArray::center(int index) const {
+    checkIndex(index);
+    size_t n = offsets[index + 1] - offsets[index];
+    if (n == 0) return Point();
+
+    double sum_x = 0, sum_y = 0;
+    for (size_t v = offsets[index]; v < offsets[index + 1]; ++v) {
+        Point p = decode(v);
+        sum_x += p.x;
+        sum_y += p.y;
+    }
+    return Point(sum_x / n, sum_y / n);
+}
+
+double CompactArray::area(int index) const {
+    std::vector<Point> verts = getVertices(index);
+    return polygonArea(verts.data(), verts.size());
+}
+
+double CompactArray::totalArea() const {
+    double total = 0;
+    for (size_t i = 0; i < size(); ++i) {
+        total += area(static_cast<int>(i));
+    }
+    return total;
+}
+
+Figure* CompactArray::createFigure(int index) const {
+    return ::createFigure(getVertices(index));
+}
+
+Array CompactArray::toArray() const {
+    Array result;
+    for (size_t i = 0; i < size(); ++i) {
+        result.addFigure(createFigure(static_cast<int>(i)));
+    }
+    return result;
+}
+
+void CompactArray::clear() {
+    floatCoords.clear();
+    fixedCoords.clear();
+    offsets.assign(1, 0);
+}
@@ -0,0 +1,90 @@
+#include "../include/concurrent_array.hpp"
+#include <stdexcept>
+
+ConcurrentArray::ConcurrentArray() : current(std::make_shared<const Storage>()) {}
+
+void ConcurrentArray::addFigure(Figure* figure) {
+    if (figure == nullptr) {
+        throw std::invalid_argument("Cannot add null figure");
+    }
+    std::shared_ptr<const Figure> owned(figure);
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto next = std::make_shared<Storage>(*current.load(std::memory_order_relaxed));
+    next->push_back(std::move(owned));
+    current.store(std::move(next), std::memory_order_release);
+}
+
+void ConcurrentArray::addFigures(const std::vector<Figure*>& figures) {
+    std::vector<std::unique_ptr<Figure>> taken;
+    try {
+        taken.reserve(figures.size());
+    } catch (...) {
+        for (Figure* figure : figures) {
+            delete figure;
+        }
+        throw;
+    }
+    for (Figure* figure : figures) {
+        taken.emplace_back(figure);
+    }
+
+    for (const auto& figure : taken) {
+        if (figure == nullptr) {
+            throw std::invalid_argument("Cannot add null figure");
+        }
+    }
+    std::vector<std::shared_ptr<const Figure>> owned;
+    owned.reserve(taken.size());
+    for (auto& figure : taken) {
+        owned.emplace_back(std::move(figure));
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto previous = current.load(std::memory_order_relaxed);
+    auto next = std::make_shared<Storage>();
+    next->reserve(previous->size() + owned.size());
+    next->insert(next->end(), previous->begin(), previous->end());
+    next->insert(next->end(), std::make_move_iterator(owned.begin()), std::make_move_iterator(owned.end()));
+    current.store(std::move(next), std::memory_order_release);
+}
+
+void ConcurrentArray::removeFigure(int index) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto previous = current.load(std::memory_order_relaxed);
+    if (index < 0 || index >= static_cast<int>(previous->size())) {
+        throw std::out_of_range("Index out of range");
+    }
+
+    auto next = std::make_shared<Storage>();
+    next->reserve(previous->size() - 1);
+    next->insert(next->end(), previous->begin(), previous->begin() + index);
+    next->insert(next->end(), previous->begin() + index + 1, previous->end());
+    current.store(std::move(next), std::memory_order_release);
+}
+
+void ConcurrentArray::clear() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    current.store(std::make_shared<const Storage>(), std::memory_order_release);
+}
+
+const Figure* ConcurrentArray::Snapshot::operator[](int index) const {
+    if (index < 0 || index >= static_cast<int>(figures->size())) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*figures)[index].get();
+}
+
+double ConcurrentArray::Snapshot::totalArea() const {
+    double total = 0;
+    for (const auto& figure : *figures) {
+        total += figure->area();
+    }
+    return total;
+}
+
+void ConcurrentArray::Snapshot::printAllFigures(std::ostream& os) const {
+    for (size_t i = 0; i < figures->size(); ++i) {
+        os << "Figure " << i << ": " << *(*figures)[i] << '\n';
+    }
+}
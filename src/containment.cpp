@@ -0,0 +1,154 @@
+#include "../include/containment.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+size_t cellIndex(double value, double origin, double step, size_t count) {
+    double cell = std::floor((value - origin) / step);
+    if (cell < 0) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(cell), count - 1);
+}
+
+}
+
+ContainmentIndex::ContainmentIndex(const Array& array) : offsets{0} {
+    size_t n = array.size();
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const Figure* figure = array.get(i);
+        const auto& verts = figure->getVertices();
+
+        BoundingBox box = figure->boundingBox();
+        if (i == 0) {
+            bounds = box;
+        } else {
+            bounds.minX = std::min(bounds.minX, box.minX);
+            bounds.minY = std::min(bounds.minY, box.minY);
+            bounds.maxX = std::max(bounds.maxX, box.maxX);
+            bounds.maxY = std::max(bounds.maxY, box.maxY);
+        }
+        boxes.push_back(box);
+
+        // Контур хранится замкнутым: первая вершина повторяется в конце
+        if (verts.size() >= 3) {
+            std::vector<Point> outline = polygonOutline(verts.data(), verts.size());
+            outline.push_back(outline.front());
+            for (const auto& p : outline) {
+                xs.push_back(p.x);
+                ys.push_back(p.y);
+            }
+        }
+        offsets.push_back(static_cast<uint32_t>(xs.size()));
+    }
+
+    // Около одной фигуры на ячейку
+    size_t side = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(n))));
+    columns = rows = side;
+    cellWidth = std::max((bounds.maxX - bounds.minX) / columns, 1e-9);
+    cellHeight = std::max((bounds.maxY - bounds.minY) / rows, 1e-9);
+
+    std::vector<uint32_t> counts(columns * rows + 1, 0);
+    auto forCells = [&](const BoundingBox& box, auto func) {
+        size_t c0 = cellIndex(box.minX, bounds.minX, cellWidth, columns);
+        size_t c1 = cellIndex(box.maxX, bounds.minX, cellWidth, columns);
+        size_t r0 = cellIndex(box.minY, bounds.minY, cellHeight, rows);
+        size_t r1 = cellIndex(box.maxY, bounds.minY, cellHeight, rows);
+        for (size_t r = r0; r <= r1; ++r) {
+            for (size_t c = c0; c <= c1; ++c) {
+                func(r * columns + c);
+            }
+        }
+    };
+    for (const auto& box : boxes) {
+        forCells(box, [&](size_t cell) { ++counts[cell + 1]; });
+    }
+
+    cellStart.resize(columns * rows + 1, 0);
+    for (size_t c = 0; c < columns * rows; ++c) {
+        cellStart[c + 1] = cellStart[c] + counts[c + 1];
+    }
+    size_t total = cellStart.back();
+    cellFigures.resize(total);
+    cellMinX.resize(total);
+    cellMinY.resize(total);
+    cellMaxX.resize(total);
+    cellMaxY.resize(total);
+
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        const BoundingBox& box = boxes[i];
+        forCells(box, [&](size_t cell) {
+            uint32_t slot = fill[cell]++;
+            cellFigures[slot] = static_cast<uint32_t>(i);
+            cellMinX[slot] = box.minX;
+            cellMinY[slot] = box.minY;
+            cellMaxX[slot] = box.maxX;
+            cellMaxY[slot] = box.maxY;
+        });
+    }
+}
+
+bool ContainmentIndex::outlineContains(size_t figure, double px, double py) const {
+    bool inside = false;
+    for (size_t k = offsets[figure]; k + 1 < offsets[figure + 1]; ++k) {
+        double ax = xs[k], ay = ys[k];
+        double bx = xs[k + 1], by = ys[k + 1];
+        bool crosses = (ay > py) != (by > py);
+        bool left = px < (bx - ax) * (py - ay) / (by - ay) + ax;
+        inside ^= crosses & left;
+    }
+    return inside;
+}
+
+void ContainmentIndex::queryInto(const Point& point, std::vector<uint8_t>& mask, std::vector<size_t>& hits) const {
+    double px = point.x, py = point.y;
+    if (size() == 0 || px < bounds.minX || px > bounds.maxX || py < bounds.minY || py > bounds.maxY) {
+        return;
+    }
+
+    size_t cell = cellIndex(py, bounds.minY, cellHeight, rows) * columns
+                + cellIndex(px, bounds.minX, cellWidth, columns);
+    size_t begin = cellStart[cell], end = cellStart[cell + 1];
+    mask.resize(end - begin);
+
+    // Проход по прямоугольникам без ветвлений
+    const double* x0 = cellMinX.data() + begin;
+    const double* y0 = cellMinY.data() + begin;
+    const double* x1 = cellMaxX.data() + begin;
+    const double* y1 = cellMaxY.data() + begin;
+    uint8_t* m = mask.data();
+    for (size_t k = 0; k < end - begin; ++k) {
+        m[k] = (px >= x0[k]) & (px <= x1[k]) & (py >= y0[k]) & (py <= y1[k]);
+    }
+
+    for (size_t k = 0; k < end - begin; ++k) {
+        size_t figure = cellFigures[begin + k];
+        if (m[k] && outlineContains(figure, px, py)) {
+            hits.push_back(figure);
+        }
+    }
+}
+
+std::vector<size_t> ContainmentIndex::query(const Point& point) const {
+    std::vector<uint8_t> mask;
+    std::vector<size_t> hits;
+    queryInto(point, mask, hits);
+    return hits;
+}
+
+std::vector<std::vector<size_t>> ContainmentIndex::query(const std::vector<Point>& points) const {
+    std::vector<std::vector<size_t>> result(points.size());
+    parallelFor(points.size(), 1024, [&](size_t, size_t begin, size_t end) {
+        std::vector<uint8_t> mask;
+        for (size_t i = begin; i < end; ++i) {
+            queryInto(points[i], mask, result[i]);
+        }
+    });
+    return result;
+}
@@ -0,0 +1,20 @@
+#include "../include/factory.hpp"
+#include "../include/pentagon.hpp"
+#include "../include/hexagon.hpp"
+#include "../include/octagon.hpp"
+#include <stdexcept>
+#include <string>
+
+Figure* createFigure(const std::vector<Point>& vertices) {
+    return createFigure(std::vector<Point>(vertices));
+}
+
+Figure* createFigure(std::vector<Point>&& vertices) {
+    switch (vertices.size()) {
+        case 5: return Pentagon::create(std::move(vertices));
+        case 6: return Hexagon::create(std::move(vertices));
+        case 8: return Octagon::create(std::move(vertices));
+        default:
+            throw std::invalid_argument("No figure with " + std::to_string(vertices.size()) + " vertices");
+    }
+}
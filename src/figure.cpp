@@ -11,30 +11,252 @@ std::istream& operator>>(std::istream& is, Figure& fig) {
     return is;
 }
 
-double Figure::area() const {
-    size_t n = vertices.size();
-    if (n < 3) return 0.0;
+namespace {
 
+// Упорядочивает точки по углу вокруг их центра масс
+void sortByAngle(Point* points, size_t n) {
     double cx = 0, cy = 0;
-    for (const auto& p : vertices) {
-        cx += p.x;
-        cy += p.y;
+    for (size_t i = 0; i < n; ++i) {
+        cx += points[i].x;
+        cy += points[i].y;
     }
     cx /= n;
     cy /= n;
 
-    std::vector<Point> sorted = vertices;
-    std::sort(sorted.begin(), sorted.end(),
+    std::sort(points, points + n,
               [&](const Point& a, const Point& b) {
                   return atan2(a.y - cy, a.x - cx) <
                          atan2(b.y - cy, b.x - cx);
               });
+}
 
+double shoelace(const Point* sorted, size_t n) {
     double area = 0.0;
     for (size_t i = 0; i < n; i++) {
         size_t j = (i + 1) % n;
         area += sorted[i].x * sorted[j].y - sorted[j].x * sorted[i].y;
     }
-
     return std::abs(area) * 0.5;
 }
+
+}
+
+std::vector<Point> polygonOutline(const Point* points, size_t n) {
+    std::vector<Point> sorted(points, points + n);
+    if (n >= 3) sortByAngle(sorted.data(), n);
+    return sorted;
+}
+
+// Небольшие многоугольники сортируются в буфере на стеке, без выделения памяти
+double polygonArea(const Point* points, size_t n) {
+    if (n < 3) return 0.0;
+
+    const size_t STACK_POINTS = 16;
+    if (n > STACK_POINTS) {
+        std::vector<Point> sorted = polygonOutline(points, n);
+        return shoelace(sorted.data(), n);
+    }
+
+    Point sorted[STACK_POINTS];
+    std::copy(points, points + n, sorted);
+    sortByAngle(sorted, n);
+    return shoelace(sorted, n);
+}
+
+bool outlineContains(const Point* outline, size_t n, const Point& p) {
+    bool inside = false;
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        const Point& a = outline[i];
+        const Point& b = outline[j];
+        if ((a.y > p.y) != (b.y > p.y) &&
+            p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+std::vector<Point> convexHull(const Point* points, size_t n) {
+    std::vector<Point> sorted(points, points + n);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Point& a, const Point& b) {
+                  return a.x < b.x || (a.x == b.x && a.y < b.y);
+              });
+    if (n < 3) return sorted;
+
+    auto cross = [](const Point& o, const Point& a, const Point& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+
+    std::vector<Point> hull(2 * n);
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], sorted[i]) <= 0) k--;
+        hull[k++] = sorted[i];
+    }
+    for (size_t i = n - 1, lower = k + 1; i > 0; --i) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], sorted[i - 1]) <= 0) k--;
+        hull[k++] = sorted[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+bool convexPolygonsOverlap(const std::vector<Point>& a, const std::vector<Point>& b) {
+    if (a.size() < 3 || b.size() < 3) return false;
+
+    for (const auto* poly : {&a, &b}) {
+        size_t n = poly->size();
+        for (size_t i = 0; i < n; ++i) {
+            const Point& p = (*poly)[i];
+            const Point& q = (*poly)[(i + 1) % n];
+            double nx = q.y - p.y, ny = p.x - q.x;
+            double eps = 1e-9 * (std::abs(nx) + std::abs(ny));
+
+            double minA = INFINITY, maxA = -INFINITY;
+            for (const auto& v : a) {
+                double d = nx * v.x + ny * v.y;
+                minA = std::min(minA, d);
+                maxA = std::max(maxA, d);
+            }
+            double minB = INFINITY, maxB = -INFINITY;
+            for (const auto& v : b) {
+                double d = nx * v.x + ny * v.y;
+                minB = std::min(minB, d);
+                maxB = std::max(maxB, d);
+            }
+            if (maxA <= minB + eps || maxB <= minA + eps) return false;
+        }
+    }
+    return true;
+}
+
+size_t heapBlockOverhead(size_t bytes) {
+    size_t chunk = std::max<size_t>(32, (bytes + sizeof(size_t) + 15) & ~size_t(15));
+    return chunk - bytes;
+}
+
+MemoryUsage Figure::memoryUsage() const {
+    MemoryUsage usage;
+    usage.liveBytes = objectSize() + vertices.size() * sizeof(Point);
+    usage.slackBytes = (vertices.capacity() - vertices.size()) * sizeof(Point);
+    usage.overheadBytes = heapBlockOverhead(objectSize());
+    if (vertices.capacity() > 0) {
+        usage.overheadBytes += heapBlockOverhead(vertices.capacity() * sizeof(Point));
+    }
+    return usage;
+}
+
+Point RegularForm::vertex(size_t k, size_t sides) const {
+    double angle = rotation + 2 * M_PI * k / sides;
+    return Point(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+}
+
+double RegularForm::area(size_t sides) const {
+    return 0.5 * sides * radius * radius * std::sin(2 * M_PI / sides);
+}
+
+std::optional<RegularForm> RegularForm::detect(const std::vector<Point>& points) {
+    size_t n = points.size();
+    if (n < 3) return std::nullopt;
+
+    double cx = 0, cy = 0;
+    for (const auto& p : points) {
+        cx += p.x;
+        cy += p.y;
+    }
+    cx /= n;
+    cy /= n;
+
+    double dx = points[0].x - cx, dy = points[0].y - cy;
+    RegularForm form{Point(cx, cy), std::hypot(dx, dy), std::atan2(dy, dx)};
+
+    // Около 18 единиц младшего разряда самой большой величины, но не меньше 1e-9
+    double scale = std::max({std::abs(cx), std::abs(cy), form.radius});
+    double tolerance = std::max(1e-9, scale * 4e-15);
+    if (!(form.radius > tolerance)) return std::nullopt;
+
+    for (size_t k = 0; k < n; ++k) {
+        Point expected = form.vertex(k, n);
+        if (!(std::abs(expected.x - points[k].x) <= tolerance) || !(std::abs(expected.y - points[k].y) <= tolerance)) {
+            return std::nullopt;
+        }
+    }
+    return form;
+}
+
+void Figure::setVertices(const std::vector<Point>& newVertices) {
+    vertices = newVertices;
+    verticesChanged();
+}
+
+void Figure::setVertices(std::vector<Point>&& newVertices) {
+    vertices = std::move(newVertices);
+    verticesChanged();
+}
+
+void Figure::clearVertices() {
+    vertices.clear();
+    verticesChanged();
+}
+
+void Figure::assignVertices(const Figure& other) {
+    vertices = other.getVertices();
+    verticesChanged();
+}
+
+// Вершины правильной фигуры принадлежат ее кешу и копируются
+void Figure::moveVertices(Figure& other) {
+    if (other.isRegular()) {
+        vertices = other.getVertices();
+    } else {
+        vertices = std::move(other.vertices);
+        other.vertices.clear();
+    }
+    verticesChanged();
+}
+
+bool Figure::sameVertices(const Figure& other, size_t sides) const {
+    const RegularForm* mine = regularForm();
+    const RegularForm* theirs = other.regularForm();
+    if (mine && theirs) {
+        for (size_t k = 0; k < sides; ++k) {
+            if (!(mine->vertex(k, sides) == theirs->vertex(k, sides))) return false;
+        }
+        return true;
+    }
+    return getVertices() == other.getVertices();
+}
+
+double Figure::area() const {
+    return polygonArea(vertices.data(), vertices.size());
+}
+
+BoundingBox Figure::boundingBox() const {
+    const auto& vertices = getVertices();
+    if (vertices.empty()) return BoundingBox();
+
+    BoundingBox box(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+    for (const auto& p : vertices) {
+        box.minX = std::min(box.minX, p.x);
+        box.minY = std::min(box.minY, p.y);
+        box.maxX = std::max(box.maxX, p.x);
+        box.maxY = std::max(box.maxY, p.y);
+    }
+    return box;
+}
+
+bool Figure::contains(const Point& p) const {
+    const auto& vertices = getVertices();
+    if (vertices.size() < 3 || !boundingBox().contains(p)) return false;
+    std::vector<Point> outline = polygonOutline(vertices.data(), vertices.size());
+    return outlineContains(outline.data(), outline.size(), p);
+}
+
+bool Figure::overlaps(const Figure& other) const {
+    if (!boundingBox().intersects(other.boundingBox())) return false;
+    const auto& mine = getVertices();
+    const auto& theirs = other.getVertices();
+    return convexPolygonsOverlap(convexHull(mine.data(), mine.size()),
+                                 convexHull(theirs.data(), theirs.size()));
+}
@@ -0,0 +1,140 @@
+#include "../include/figure_query.hpp"
+#include "../include/parallel.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const size_t MIN_CHUNK = 16384;
+const uint8_t NO_TYPE = 0xff;
+
+}
+
+FigureQuery::FigureQuery(const Array& array) {
+    size_t n = array.size();
+    typeIds.resize(n);
+    areas.resize(n);
+    centerX.resize(n);
+    centerY.resize(n);
+    minX.resize(n);
+    minY.resize(n);
+    maxX.resize(n);
+    maxY.resize(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        std::type_index type = array.get(i)->figureType();
+        auto it = std::find(types.begin(), types.end(), type);
+        if (it == types.end()) {
+            if (types.size() == NO_TYPE) {
+                throw std::length_error("Too many figure types for FigureQuery");
+            }
+            types.push_back(type);
+            it = types.end() - 1;
+        }
+        typeIds[i] = static_cast<uint8_t>(it - types.begin());
+    }
+
+    parallelFor(n, 4096, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Figure* figure = array.get(i);
+            Point c = figure->center();
+            BoundingBox box = figure->boundingBox();
+            areas[i] = figure->area();
+            centerX[i] = c.x;
+            centerY[i] = c.y;
+            minX[i] = box.minX;
+            minY[i] = box.minY;
+            maxX[i] = box.maxX;
+            maxY[i] = box.maxY;
+        }
+    });
+}
+
+FigureQuery& FigureQuery::ofType(std::type_index type) {
+    auto it = std::find(types.begin(), types.end(), type);
+    uint8_t id = it == types.end() ? NO_TYPE : static_cast<uint8_t>(it - types.begin());
+    predicates.push_back({Kind::Type, id, 0, BoundingBox()});
+    return *this;
+}
+
+FigureQuery& FigureQuery::areaAbove(double value) {
+    predicates.push_back({Kind::AreaAbove, 0, value, BoundingBox()});
+    return *this;
+}
+
+FigureQuery& FigureQuery::areaBelow(double value) {
+    predicates.push_back({Kind::AreaBelow, 0, value, BoundingBox()});
+    return *this;
+}
+
+FigureQuery& FigureQuery::centerIn(const BoundingBox& box) {
+    predicates.push_back({Kind::CenterIn, 0, 0, box});
+    return *this;
+}
+
+FigureQuery& FigureQuery::intersects(const BoundingBox& box) {
+    predicates.push_back({Kind::Intersects, 0, 0, box});
+    return *this;
+}
+
+FigureQuery& FigureQuery::reset() {
+    predicates.clear();
+    return *this;
+}
+
+void FigureQuery::apply(const Predicate& p, uint8_t* selected, size_t begin, size_t end) const {
+    const BoundingBox& b = p.box;
+    switch (p.kind) {
+        case Kind::Type:
+            for (size_t i = begin; i < end; ++i) {
+                selected[i] &= typeIds[i] == p.type;
+            }
+            break;
+        case Kind::AreaAbove:
+            for (size_t i = begin; i < end; ++i) {
+                selected[i] &= areas[i] > p.value;
+            }
+            break;
+        case Kind::AreaBelow:
+            for (size_t i = begin; i < end; ++i) {
+                selected[i] &= areas[i] < p.value;
+            }
+            break;
+        case Kind::CenterIn:
+            for (size_t i = begin; i < end; ++i) {
+                selected[i] &= (centerX[i] >= b.minX) & (centerX[i] <= b.maxX) &
+                               (centerY[i] >= b.minY) & (centerY[i] <= b.maxY);
+            }
+            break;
+        case Kind::Intersects:
+            for (size_t i = begin; i < end; ++i) {
+                selected[i] &= (minX[i] <= b.maxX) & (b.minX <= maxX[i]) &
+                               (minY[i] <= b.maxY) & (b.minY <= maxY[i]);
+            }
+            break;
+    }
+}
+
+std::vector<uint8_t> FigureQuery::selection() const {
+    std::vector<uint8_t> selected(size(), 1);
+    parallelFor(size(), MIN_CHUNK, [&](size_t, size_t begin, size_t end) {
+        for (const auto& predicate : predicates) {
+            apply(predicate, selected.data(), begin, end);
+        }
+    });
+    return selected;
+}
+
+std::vector<size_t> FigureQuery::indices() const {
+    std::vector<uint8_t> selected = selection();
+    std::vector<size_t> result;
+    for (size_t i = 0; i < selected.size(); ++i) {
+        if (selected[i]) result.push_back(i);
+    }
+    return result;
+}
+
+size_t FigureQuery::count() const {
+    std::vector<uint8_t> selected = selection();
+    return std::count(selected.begin(), selected.end(), 1);
+}
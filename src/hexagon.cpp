@@ -1,4 +1,6 @@
 #include "../include/hexagon.hpp"
+#include "../include/regular.hpp"
+#include "../include/trace.hpp"
 #include <stdexcept>
 
 Hexagon::Hexagon(const std::vector<Point>& vertices) {
@@ -15,12 +17,29 @@ Hexagon::Hexagon(std::vector<Point>&& vertices) {
     setVertices(std::move(vertices));
 }
 
+Hexagon* Hexagon::create(const std::vector<Point>& vertices) {
+    return create(std::vector<Point>(vertices));
+}
+
+Hexagon* Hexagon::create(std::vector<Point>&& vertices) {
+    if (vertices.size() == 6) {
+        if (auto form = RegularForm::detect(vertices)) {
+            return new RegularHexagon(*form);
+        }
+    }
+    return new Hexagon(std::move(vertices));
+}
+
+Hexagon* Hexagon::regular(Point center, double radius, double rotation) {
+    return new RegularHexagon(center, radius, rotation);
+}
+
 Hexagon::Hexagon(const Hexagon& other) {
-    setVertices(other.getVertices());
+    assignVertices(other);
 }
 
 Hexagon::Hexagon(Hexagon&& other) noexcept {
-    setVertices(std::move(const_cast<Hexagon&>(other).getVertices()));
+    moveVertices(other);
 }
 
 Point Hexagon::center() const {
@@ -48,6 +67,7 @@ void Hexagon::print(std::ostream& os) const {
 }
 
 void Hexagon::read(std::istream& is) {
+    TRACE_SCOPE("Hexagon::read");
     std::vector<Point> newVertices;
     for (int i = 0; i < 6; ++i) {
         Point p;
@@ -60,19 +80,19 @@ void Hexagon::read(std::istream& is) {
 bool Hexagon::operator==(const Figure& other) const {
     const Hexagon* hexagon = dynamic_cast<const Hexagon*>(&other);
     if (!hexagon) return false;
-    return getVertices() == hexagon->getVertices();
+    return sameVertices(*hexagon, 6);
 }
 
 Hexagon& Hexagon::operator=(const Hexagon& other) {
     if (this != &other) {
-        vertices = other.vertices;
+        assignVertices(other);
     }
     return *this;
 }
 
 Hexagon& Hexagon::operator=(Hexagon&& other) noexcept {
     if (this != &other) {
-        vertices = std::move(other.vertices);
+        moveVertices(other);
     }
     return *this;
 }
@@ -82,7 +102,9 @@ Hexagon& Hexagon::operator=(const Figure& other) {
     if (!hexagon) {
         throw std::invalid_argument("Cannot assign non-Hexagon to Hexagon");
     }
-    setVertices(hexagon->getVertices());
+    if (this != hexagon) {
+        assignVertices(*hexagon);
+    }
     return *this;
 }
 
@@ -91,6 +113,8 @@ Hexagon& Hexagon::operator=(Figure&& other) {
     if (!hexagon) {
         throw std::invalid_argument("Cannot move assign non-Hexagon to Hexagon");
     }
-    setVertices(std::move(hexagon->getVertices()));
+    if (this != hexagon) {
+        moveVertices(*hexagon);
+    }
     return *this;
 }
\ No newline at end of file
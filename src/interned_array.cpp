@@ -0,0 +1,170 @@
+#include "../include/interned_array.hpp"
+#include "../include/factory.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Размер ячейки равен допуску Point::operator==: равные точки лежат
+// в одной или в соседних ячейках
+const double CELL = 1e-6;
+
+// Номер ячейки должен помещаться в int64_t; NaN не проходит проверку
+int64_t cellIndex(double value) {
+    double cell = std::floor(value / CELL);
+    if (!(std::abs(cell) < 9e18)) {
+        throw std::out_of_range("Vertex coordinate cannot be interned");
+    }
+    return static_cast<int64_t>(cell);
+}
+
+std::pair<int64_t, int64_t> cellOf(const Point& p) {
+    return {cellIndex(p.x), cellIndex(p.y)};
+}
+
+}
+
+InternedArray::InternedArray() : offsets{0} {}
+
+void InternedArray::checkIndex(int index) const {
+    if (index < 0 || index >= static_cast<int>(size())) {
+        throw std::out_of_range("Index out of range");
+    }
+}
+
+uint32_t InternedArray::intern(const Point& p) {
+    if (!cellsBuilt) {
+        rebuildCells();
+    }
+
+    auto cell = cellOf(p);
+    for (int64_t dx = -1; dx <= 1; ++dx) {
+        for (int64_t dy = -1; dy <= 1; ++dy) {
+            auto range = cells.equal_range({cell.first + dx, cell.second + dy});
+            for (auto it = range.first; it != range.second; ++it) {
+                if (pool[it->second] == p) {
+                    return it->second;
+                }
+            }
+        }
+    }
+
+    if (pool.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Vertex pool is full");
+    }
+    uint32_t id = static_cast<uint32_t>(pool.size());
+    pool.push_back(p);
+    cells.emplace(cell, id);
+    return id;
+}
+
+void InternedArray::rebuildCells() {
+    cells.clear();
+    cells.reserve(pool.size());
+    for (uint32_t id = 0; id < pool.size(); ++id) {
+        cells.emplace(cellOf(pool[id]), id);
+    }
+    cellsBuilt = true;
+}
+
+void InternedArray::dropCells() {
+    decltype(cells)().swap(cells);
+    cellsBuilt = false;
+}
+
+void InternedArray::shrink() {
+    dropCells();
+    pool.shrink_to_fit();
+    indices.shrink_to_fit();
+    offsets.shrink_to_fit();
+}
+
+// При ошибке убираются индексы и вершины пула, добавленные этой фигурой
+void InternedArray::addFigure(const Figure& figure) {
+    size_t indicesBefore = indices.size();
+    size_t poolBefore = pool.size();
+    try {
+        for (const auto& p : figure.getVertices()) {
+            indices.push_back(intern(p));
+        }
+        offsets.push_back(static_cast<uint32_t>(indices.size()));
+    } catch (...) {
+        indices.resize(indicesBefore);
+        if (pool.size() != poolBefore) {
+            pool.resize(poolBefore);
+            dropCells();
+        }
+        throw;
+    }
+}
+
+void InternedArray::addFigures(const Array& array) {
+    for (const Figure* figure : array) {
+        addFigure(*figure);
+    }
+}
+
+size_t InternedArray::vertexCount(int index) const {
+    checkIndex(index);
+    return offsets[index + 1] - offsets[index];
+}
+
+std::vector<Point> InternedArray::getVertices(int index) const {
+    checkIndex(index);
+    std::vector<Point> result;
+    result.reserve(offsets[index + 1] - offsets[index]);
+    for (size_t k = offsets[index]; k < offsets[index + 1]; ++k) {
+        result.push_back(pool[indices[k]]);
+    }
+    return result;
+}
+
+Point InternedArray::center(int index) const {
+    checkIndex(index);
+    size_t n = offsets[index + 1] - offsets[index];
+    if (n == 0) return Point();
+
+    double sum_x = 0, sum_y = 0;
+    for (size_t k = offsets[index]; k < offsets[index + 1]; ++k) {
+        sum_x += pool[indices[k]].x;
+        sum_y += pool[indices[k]].y;
+    }
+    return Point(sum_x / n, sum_y / n);
+}
+
+double InternedArray::area(int index) const {
+    std::vector<Point> verts = getVertices(index);
+    return polygonArea(verts.data(), verts.size());
+}
+
+double InternedArray::totalArea() const {
+    double total = 0;
+    for (size_t i = 0; i < size(); ++i) {
+        total += area(static_cast<int>(i));
+    }
+    return total;
+}
+
+void InternedArray::translate(double dx, double dy) {
+    transform([dx, dy](const Point& p) { return Point(p.x + dx, p.y + dy); });
+}
+
+Figure* InternedArray::createFigure(int index) const {
+    return ::createFigure(getVertices(index));
+}
+
+Array InternedArray::toArray() const {
+    Array result;
+    for (size_t i = 0; i < size(); ++i) {
+        result.addFigure(createFigure(static_cast<int>(i)));
+    }
+    return result;
+}
+
+void InternedArray::clear() {
+    pool.clear();
+    indices.clear();
+    offsets.assign(1, 0);
+    dropCells();
+}
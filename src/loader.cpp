@@ -0,0 +1,203 @@
+#include "../include/loader.hpp"
+#include "../include/bounded_queue.hpp"
+#include "../include/factory.hpp"
+#include "../include/pentagon.hpp"
+#include "../include/hexagon.hpp"
+#include "../include/octagon.hpp"
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const size_t QUEUE_CAPACITY = 4;
+
+struct Batch {
+    std::vector<std::unique_ptr<Figure>> figures;
+    std::vector<double> areas;
+    std::vector<Point> centers;
+};
+
+size_t expectedVertices(std::string_view name) {
+    if (name == "Pentagon") return 5;
+    if (name == "Hexagon") return 6;
+    if (name == "Octagon") return 8;
+    return 0;
+}
+
+const char* typeName(const Figure& figure) {
+    if (dynamic_cast<const Pentagon*>(&figure)) return "Pentagon";
+    if (dynamic_cast<const Hexagon*>(&figure)) return "Hexagon";
+    if (dynamic_cast<const Octagon*>(&figure)) return "Octagon";
+    throw std::invalid_argument("Unknown figure type");
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+Figure* parseLine(const char* pos, const char* end, size_t line) {
+    auto fail = [line]() {
+        return std::runtime_error("Invalid figure at line " + std::to_string(line));
+    };
+
+    while (pos < end && isSpace(*pos)) ++pos;
+    const char* nameEnd = pos;
+    while (nameEnd < end && !isSpace(*nameEnd)) ++nameEnd;
+    size_t n = expectedVertices(std::string_view(pos, nameEnd - pos));
+    if (n == 0) throw fail();
+    pos = nameEnd;
+
+    std::vector<Point> verts(n);
+    for (size_t k = 0; k < 2 * n; ++k) {
+        while (pos < end && isSpace(*pos)) ++pos;
+        if (pos == end) throw fail();
+        // from_chars не зависит от локали
+        double value;
+        auto [next, status] = std::from_chars(pos, end, value);
+        if (status != std::errc()) throw fail();
+        pos = next;
+        (k % 2 == 0 ? verts[k / 2].x : verts[k / 2].y) = value;
+    }
+    while (pos < end && isSpace(*pos)) ++pos;
+    if (pos != end) throw fail();
+
+    return createFigure(std::move(verts));
+}
+
+}
+
+void saveDataset(std::ostream& os, const Array& array) {
+    std::streamsize precision = os.precision(17);
+    for (const Figure* figure : array) {
+        os << typeName(*figure);
+        for (const auto& p : figure->getVertices()) {
+            os << ' ' << p.x << ' ' << p.y;
+        }
+        os << '\n';
+    }
+    os.precision(precision);
+}
+
+LoadResult loadDataset(const std::string& path, size_t blockSize) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    if (blockSize == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+
+    BoundedQueue<std::string> text(QUEUE_CAPACITY);
+    BoundedQueue<Batch> parsed(QUEUE_CAPACITY);
+    BoundedQueue<Batch> measured(QUEUE_CAPACITY);
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto stop = [&](std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = e;
+        }
+        text.close();
+        parsed.close();
+        measured.close();
+    };
+
+    // Чтение: блоки обрезаются по последнему переводу строки
+    std::thread reader([&] {
+        try {
+            std::string carry;
+            std::vector<char> buffer(blockSize);
+            while (in) {
+                in.read(buffer.data(), buffer.size());
+                std::string block = std::move(carry);
+                block.append(buffer.data(), in.gcount());
+
+                size_t cut = block.rfind('\n');
+                if (in && cut == std::string::npos) {
+                    carry = std::move(block);
+                    continue;
+                }
+                if (in) {
+                    carry = block.substr(cut + 1);
+                    block.resize(cut + 1);
+                } else {
+                    carry.clear();
+                }
+                if (!text.push(std::move(block))) return;
+            }
+            if (in.bad()) throw std::runtime_error("Failed to read " + path);
+            text.close();
+        } catch (...) {
+            stop(std::current_exception());
+        }
+    });
+
+    // Разбор строк в фигуры
+    std::thread parser([&] {
+        try {
+            size_t line = 0;
+            while (auto block = text.pop()) {
+                Batch batch;
+                const char* pos = block->data();
+                const char* end = pos + block->size();
+                while (pos < end) {
+                    const char* lineEnd = std::find(pos, end, '\n');
+                    line++;
+                    const char* check = pos;
+                    while (check < lineEnd && isSpace(*check)) ++check;
+                    if (check != lineEnd) {
+                        batch.figures.emplace_back(parseLine(pos, lineEnd, line));
+                    }
+                    pos = lineEnd == end ? end : lineEnd + 1;
+                }
+                if (!parsed.push(std::move(batch))) return;
+            }
+            parsed.close();
+        } catch (...) {
+            stop(std::current_exception());
+        }
+    });
+
+    // Предварительный расчет площади и центра
+    std::thread metrics([&] {
+        try {
+            while (auto batch = parsed.pop()) {
+                for (const auto& figure : batch->figures) {
+                    batch->areas.push_back(figure->area());
+                    batch->centers.push_back(figure->center());
+                }
+                if (!measured.push(std::move(*batch))) return;
+            }
+            measured.close();
+        } catch (...) {
+            stop(std::current_exception());
+        }
+    });
+
+    LoadResult result;
+    try {
+        while (auto batch = measured.pop()) {
+            for (auto& figure : batch->figures) {
+                result.figures.addFigure(figure.get());
+                figure.release();
+            }
+            result.areas.insert(result.areas.end(), batch->areas.begin(), batch->areas.end());
+            result.centers.insert(result.centers.end(), batch->centers.begin(), batch->centers.end());
+        }
+    } catch (...) {
+        stop(std::current_exception());
+    }
+
+    reader.join();
+    parser.join();
+    metrics.join();
+
+    if (error) std::rethrow_exception(error);
+    return result;
+}
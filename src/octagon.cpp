@@ -1,4 +1,6 @@
 #include "../include/octagon.hpp"
+#include "../include/regular.hpp"
+#include "../include/trace.hpp"
 #include <stdexcept>
 
 Octagon::Octagon(const std::vector<Point>& vertices) {
@@ -15,12 +17,29 @@ Octagon::Octagon(std::vector<Point>&& vertices) {
     setVertices(std::move(vertices));
 }
 
+Octagon* Octagon::create(const std::vector<Point>& vertices) {
+    return create(std::vector<Point>(vertices));
+}
+
+Octagon* Octagon::create(std::vector<Point>&& vertices) {
+    if (vertices.size() == 8) {
+        if (auto form = RegularForm::detect(vertices)) {
+            return new RegularOctagon(*form);
+        }
+    }
+    return new Octagon(std::move(vertices));
+}
+
+Octagon* Octagon::regular(Point center, double radius, double rotation) {
+    return new RegularOctagon(center, radius, rotation);
+}
+
 Octagon::Octagon(const Octagon& other) {
-    setVertices(other.getVertices());
+    assignVertices(other);
 }
 
 Octagon::Octagon(Octagon&& other) noexcept {
-    setVertices(std::move(const_cast<Octagon&>(other).getVertices()));
+    moveVertices(other);
 }
 
 Point Octagon::center() const {
@@ -48,6 +67,7 @@ void Octagon::print(std::ostream& os) const {
 }
 
 void Octagon::read(std::istream& is) {
+    TRACE_SCOPE("Octagon::read");
     std::vector<Point> newVertices;
     for (int i = 0; i < 8; ++i) {
         Point p;
@@ -60,19 +80,19 @@ void Octagon::read(std::istream& is) {
 bool Octagon::operator==(const Figure& other) const {
     const Octagon* octagon = dynamic_cast<const Octagon*>(&other);
     if (!octagon) return false;
-    return getVertices() == octagon->getVertices();
+    return sameVertices(*octagon, 8);
 }
 
 Octagon& Octagon::operator=(const Octagon& other) {
     if (this != &other) {
-        vertices = other.vertices;
+        assignVertices(other);
     }
     return *this;
 }
 
 Octagon& Octagon::operator=(Octagon&& other) noexcept {
     if (this != &other) {
-        vertices = std::move(other.vertices);
+        moveVertices(other);
     }
     return *this;
 }
@@ -82,7 +102,9 @@ Octagon& Octagon::operator=(const Figure& other) {
     if (!octagon) {
         throw std::invalid_argument("Cannot assign non-Octagon to Octagon");
     }
-    setVertices(octagon->getVertices());
+    if (this != octagon) {
+        assignVertices(*octagon);
+    }
     return *this;
 }
 
@@ -91,6 +113,8 @@ Octagon& Octagon::operator=(Figure&& other) {
     if (!octagon) {
         throw std::invalid_argument("Cannot move assign non-Octagon to Octagon");
     }
-    setVertices(std::move(octagon->getVertices()));
+    if (this != octagon) {
+        moveVertices(*octagon);
+    }
     return *this;
 }
\ No newline at end of file
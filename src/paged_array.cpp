@@ -0,0 +1,184 @@
+#include "../include/paged_array.hpp"
+#include "../include/factory.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const char MAGIC[4] = {'F', 'I', 'G', 'P'};
+const size_t MAX_VERTICES = 8;
+const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint64_t) + sizeof(uint64_t);
+const size_t RECORD_SIZE = sizeof(uint32_t) + MAX_VERTICES * 2 * sizeof(double);
+
+}
+
+void PagedArray::write(const std::string& path, const Array& array, size_t chunkSize) {
+    if (chunkSize == 0) {
+        throw std::invalid_argument("Chunk size must be positive");
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open " + path + " for writing");
+    }
+
+    uint64_t count = array.size();
+    uint64_t chunk = chunkSize;
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+
+    char record[RECORD_SIZE];
+    for (const Figure* figure : array) {
+        // Записываются только фигуры, которые createFigure восстановит при чтении
+        const auto& verts = figure->getVertices();
+        if (verts.size() != 5 && verts.size() != 6 && verts.size() != 8) {
+            throw std::invalid_argument("Figure with " + std::to_string(verts.size()) +
+                                        " vertices cannot be stored in a paged file");
+        }
+
+        std::memset(record, 0, RECORD_SIZE);
+        uint32_t n = static_cast<uint32_t>(verts.size());
+        std::memcpy(record, &n, sizeof(n));
+        for (size_t k = 0; k < verts.size(); ++k) {
+            double coords[2] = {verts[k].x, verts[k].y};
+            std::memcpy(record + sizeof(n) + k * sizeof(coords), coords, sizeof(coords));
+        }
+        out.write(record, RECORD_SIZE);
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+PagedArray::PagedArray(const std::string& path, size_t cacheChunks)
+    : path(path), count(0), chunkSize_(0), cacheChunks(cacheChunks == 0 ? 1 : cacheChunks),
+      lastChunk(SIZE_MAX), readAheadChunk(SIZE_MAX) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    char magic[sizeof(MAGIC)];
+    uint64_t fileCount = 0, fileChunk = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
+    in.read(reinterpret_cast<char*>(&fileChunk), sizeof(fileChunk));
+    if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || fileChunk == 0) {
+        throw std::runtime_error("Invalid paged figure file " + path);
+    }
+
+    count = fileCount;
+    chunkSize_ = fileChunk;
+}
+
+std::shared_ptr<const PagedArray::Chunk> PagedArray::loadChunk(const std::string& path, size_t count,
+                                                                size_t chunkSize, size_t chunk) {
+    size_t first = chunk * chunkSize;
+    size_t n = std::min(chunkSize, count - first);
+
+    std::ifstream in(path, std::ios::binary);
+    in.seekg(HEADER_SIZE + first * RECORD_SIZE);
+    std::vector<char> buffer(n * RECORD_SIZE);
+    in.read(buffer.data(), buffer.size());
+    if (!in) {
+        throw std::runtime_error("Failed to read chunk from " + path);
+    }
+
+    auto result = std::make_shared<Chunk>();
+    result->reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const char* record = buffer.data() + i * RECORD_SIZE;
+        uint32_t vertexCount;
+        std::memcpy(&vertexCount, record, sizeof(vertexCount));
+
+        std::vector<Point> verts(std::min<size_t>(vertexCount, MAX_VERTICES));
+        for (size_t k = 0; k < verts.size(); ++k) {
+            double coords[2];
+            std::memcpy(coords, record + sizeof(vertexCount) + k * sizeof(coords), sizeof(coords));
+            verts[k] = Point(coords[0], coords[1]);
+        }
+        result->push_back(std::shared_ptr<const Figure>(createFigure(std::move(verts))));
+    }
+    return result;
+}
+
+void PagedArray::insertChunk(size_t chunk, std::shared_ptr<const Chunk> data) const {
+    if (cached.count(chunk)) return;
+
+    lru.emplace_front(chunk, std::move(data));
+    cached[chunk] = lru.begin();
+    if (lru.size() > cacheChunks) {
+        cached.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+std::shared_ptr<const PagedArray::Chunk> PagedArray::getChunk(size_t chunk) const {
+    if (readAhead.valid() && readAheadChunk == chunk) {
+        insertChunk(chunk, readAhead.get());
+    }
+
+    std::shared_ptr<const Chunk> result;
+    auto it = cached.find(chunk);
+    if (it != cached.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        result = it->second->second;
+    } else {
+        result = loadChunk(path, count, chunkSize_, chunk);
+        insertChunk(chunk, result);
+    }
+
+    // Последовательный обход: заранее читаем следующий кусок
+    size_t next = chunk + 1;
+    bool sequential = lastChunk != SIZE_MAX && chunk == lastChunk + 1;
+    lastChunk = chunk;
+    if (sequential && next * chunkSize_ < count && !cached.count(next)) {
+        // Ошибка чужого фонового чтения не относится к текущему обращению:
+        // кусок будет прочитан заново и ошибка проявится при обращении к нему
+        if (readAhead.valid()) {
+            size_t pending = readAheadChunk;
+            try {
+                insertChunk(pending, readAhead.get());
+            } catch (const std::exception&) {
+            }
+        }
+        readAheadChunk = next;
+        readAhead = std::async(std::launch::async, [path = path, count = count, chunkSize = chunkSize_, next] {
+            return loadChunk(path, count, chunkSize, next);
+        });
+    }
+
+    return result;
+}
+
+std::shared_ptr<const Figure> PagedArray::operator[](int index) const {
+    if (index < 0 || index >= static_cast<int>(count)) {
+        throw std::out_of_range("Index out of range");
+    }
+    size_t i = static_cast<size_t>(index);
+    return (*getChunk(i / chunkSize_))[i % chunkSize_];
+}
+
+double PagedArray::totalArea() const {
+    double total = 0;
+    for (size_t first = 0; first < count; first += chunkSize_) {
+        for (const auto& figure : *getChunk(first / chunkSize_)) {
+            total += figure->area();
+        }
+    }
+    return total;
+}
+
+void PagedArray::printAllFigures(std::ostream& os) const {
+    size_t i = 0;
+    for (size_t first = 0; first < count; first += chunkSize_) {
+        for (const auto& figure : *getChunk(first / chunkSize_)) {
+            os << "Figure " << i++ << ": " << *figure << '\n';
+        }
+    }
+}
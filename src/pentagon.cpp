@@ -1,4 +1,6 @@
 #include "../include/pentagon.hpp"
+#include "../include/regular.hpp"
+#include "../include/trace.hpp"
 #include <stdexcept>
 
 Pentagon::Pentagon(const std::vector<Point>& vertices) {
@@ -15,12 +17,29 @@ Pentagon::Pentagon(std::vector<Point>&& vertices) {
     setVertices(std::move(vertices));
 }
 
+Pentagon* Pentagon::create(const std::vector<Point>& vertices) {
+    return create(std::vector<Point>(vertices));
+}
+
+Pentagon* Pentagon::create(std::vector<Point>&& vertices) {
+    if (vertices.size() == 5) {
+        if (auto form = RegularForm::detect(vertices)) {
+            return new RegularPentagon(*form);
+        }
+    }
+    return new Pentagon(std::move(vertices));
+}
+
+Pentagon* Pentagon::regular(Point center, double radius, double rotation) {
+    return new RegularPentagon(center, radius, rotation);
+}
+
 Pentagon::Pentagon(const Pentagon& other) {
-    setVertices(other.getVertices());
+    assignVertices(other);
 }
 
 Pentagon::Pentagon(Pentagon&& other) noexcept {
-    setVertices(std::move(const_cast<Pentagon&>(other).getVertices()));
+    moveVertices(other);
 }
 
 Point Pentagon::center() const {
@@ -48,6 +67,7 @@ void Pentagon::print(std::ostream& os) const {
 }
 
 void Pentagon::read(std::istream& is) {
+    TRACE_SCOPE("Pentagon::read");
     std::vector<Point> newVertices;
     for (int i = 0; i < 5; ++i) {
         Point p;
@@ -60,19 +80,19 @@ void Pentagon::read(std::istream& is) {
 bool Pentagon::operator==(const Figure& other) const {
     const Pentagon* pentagon = dynamic_cast<const Pentagon*>(&other);
     if (!pentagon) return false;
-    return getVertices() == pentagon->getVertices();
+    return sameVertices(*pentagon, 5);
 }
 
 Pentagon& Pentagon::operator=(const Pentagon& other) {
     if (this != &other) {
-        vertices = other.vertices;
+        assignVertices(other);
     }
     return *this;
 }
 
 Pentagon& Pentagon::operator=(Pentagon&& other) noexcept {
     if (this != &other) {
-        vertices = std::move(other.vertices);
+        moveVertices(other);
     }
     return *this;
 }
@@ -82,7 +102,9 @@ Pentagon& Pentagon::operator=(const Figure& other) {
     if (!pentagon) {
         throw std::invalid_argument("Cannot assign non-Pentagon to Pentagon");
     }
-    setVertices(pentagon->getVertices());
+    if (this != pentagon) {
+        assignVertices(*pentagon);
+    }
     return *this;
 }
 
@@ -91,7 +113,9 @@ Pentagon& Pentagon::operator=(Figure&& other) {
     if (!pentagon) {
         throw std::invalid_argument("Cannot move assign non-Pentagon to Pentagon");
     }
-    setVertices(std::move(pentagon->vertices));
+    if (this != pentagon) {
+        moveVertices(*pentagon);
+    }
     return *this;
 
 }
\ No newline at end of file
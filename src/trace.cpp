@@ -0,0 +1,110 @@
+#include "../include/trace.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> Trace::enabledFlag{false};
+
+namespace {
+
+struct ThreadBuffer {
+    uint32_t thread;
+    std::mutex mutex;
+    uint64_t written = 0;
+    Trace::Event events[Trace::BUFFER_EVENTS];
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+std::vector<ThreadBuffer*> freeBuffers;
+
+// Поток владеет буфером до завершения, затем возвращает его в список
+// свободных. События завершившихся потоков остаются доступны для dump,
+// а число буферов ограничено числом одновременно писавших потоков.
+struct BufferLease {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferLease() {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            freeBuffers.push_back(buffer);
+        }
+    }
+};
+
+thread_local BufferLease lease;
+
+ThreadBuffer* threadBuffer() {
+    if (!lease.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (!freeBuffers.empty()) {
+            lease.buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+        } else {
+            buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffers.back()->thread = static_cast<uint32_t>(buffers.size());
+            lease.buffer = buffers.back().get();
+        }
+    }
+    return lease.buffer;
+}
+
+// Наносекунды как микросекунды с тремя знаками после точки, без
+// округления и без изменения состояния потока
+std::string micros(int64_t ns) {
+    std::string fraction = std::to_string(ns % 1000);
+    return std::to_string(ns / 1000) + "." + std::string(3 - fraction.size(), '0') + fraction;
+}
+
+}
+
+void Trace::record(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer* buffer = threadBuffer();
+    // Мьютекс буфера захватывает кто-то кроме владельца только в dump и reset
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->events[buffer->written % BUFFER_EVENTS] = Event{name, start, end - start};
+    buffer->written++;
+}
+
+void Trace::dump(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        uint64_t written = buffer->written;
+        uint64_t begin = written > BUFFER_EVENTS ? written - BUFFER_EVENTS : 0;
+        for (uint64_t i = begin; i < written; ++i) {
+            const Event& event = buffer->events[i % BUFFER_EVENTS];
+            if (!first) os << ",";
+            first = false;
+            os << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread
+               << ",\"ts\":" << micros(event.start) << ",\"dur\":" << micros(event.duration) << "}";
+        }
+    }
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+size_t Trace::eventCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t count = 0;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->written > BUFFER_EVENTS ? BUFFER_EVENTS : buffer->written;
+    }
+    return count;
+}
+
+size_t Trace::bufferCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return buffers.size();
+}
+
+void Trace::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->written = 0;
+    }
+}
@@ -3,8 +3,57 @@
 #include "../include/hexagon.hpp"
 #include "../include/octagon.hpp"
 #include "../include/array.hpp"
+#include "../include/compact_array.hpp"
+#include "../include/factory.hpp"
+#include "../include/containment.hpp"
+#include "../include/paged_array.hpp"
+#include "../include/archive.hpp"
+#include "../include/concurrent_array.hpp"
+#include "../include/figure_query.hpp"
+#include "../include/trace.hpp"
+#include "../include/interned_array.hpp"
+#include "../include/array_diff.hpp"
+#include "../include/loader.hpp"
+#include "../include/area_pyramid.hpp"
+#include "../include/regular.hpp"
+#include <fstream>
+#include <thread>
+#include <cstdio>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+// Глобальные счетчики выделений памяти: количество вызовов и байты,
+// занятые в куче сейчас (размер блока хранится в заголовке)
+static std::atomic<size_t> allocationCount{0};
+static std::atomic<long long> heapBytes{0};
+static const size_t HEADER = 16;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    heapBytes += size;
+    if (char* p = static_cast<char*>(std::malloc(size + HEADER))) {
+        *reinterpret_cast<size_t*>(p) = size;
+        return p + HEADER;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = static_cast<char*>(p) - HEADER;
+    heapBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
 
 // Вспомогательная функция для сравнения double с учетом погрешности
 bool doubleEquals(double a, double b, double epsilon = 1e-6) {
@@ -297,6 +346,189 @@ TEST_F(OctagonTest, AssignmentOperators) {
     */
 }
 
+// ==================== REGULAR FORM TESTS ====================
+
+TEST(RegularFormTest, ClosedFormMatchesVertices) {
+    RegularPentagon pentagon(Point(1, 2), 3.0, 0.25);
+    RegularHexagon hexagon(Point(-1, 0), 1.0);
+    RegularOctagon octagon(Point(0, 5), 2.0, M_PI / 8);
+
+    for (const Figure* figure : std::initializer_list<const Figure*>{&pentagon, &hexagon, &octagon}) {
+        ASSERT_TRUE(figure->isRegular());
+        const auto& form = *figure->regularForm();
+        const auto& verts = figure->getVertices();
+        for (size_t k = 0; k < verts.size(); ++k) {
+            EXPECT_TRUE(verts[k] == form.vertex(k, verts.size()));
+        }
+        EXPECT_NEAR(figure->area(), polygonArea(verts.data(), verts.size()), 1e-9);
+        EXPECT_TRUE(figure->center() == form.center);
+    }
+
+    // Площадь правильного шестиугольника с радиусом 1
+    EXPECT_NEAR(hexagon.area(), 3 * std::sqrt(3) / 2, 1e-12);
+    EXPECT_THROW(RegularHexagon(Point(), 0), std::invalid_argument);
+}
+
+TEST(RegularFormTest, DetectedOnConstruction) {
+    std::vector<Point> verts;
+    for (int k = 0; k < 6; ++k) {
+        verts.push_back({2 + 1.5 * std::cos(0.3 + M_PI * k / 3), -1 + 1.5 * std::sin(0.3 + M_PI * k / 3)});
+    }
+
+    long long before = heapBytes;
+    Figure* detected = createFigure(verts);
+    // Вершины не хранятся, пока их не запросят
+    EXPECT_EQ(heapBytes - before, static_cast<long long>(sizeof(RegularHexagon)));
+    ASSERT_TRUE(detected->isRegular());
+    EXPECT_TRUE(detected->center() == Point(2, -1));
+    EXPECT_NEAR(detected->regularForm()->radius, 1.5, 1e-12);
+
+    EXPECT_TRUE(*detected == Hexagon(verts));
+    EXPECT_TRUE(Hexagon(verts) == *detected);
+    EXPECT_EQ(detected->getVertices().size(), 6);
+    for (size_t k = 0; k < 6; ++k) {
+        EXPECT_TRUE(detected->getVertices()[k] == verts[k]);
+    }
+    detected->releaseVertexCache();
+    EXPECT_EQ(heapBytes - before, static_cast<long long>(sizeof(RegularHexagon)));
+    delete detected;
+
+    // Нарушен порядок обхода - фигура хранится как есть
+    std::swap(verts[0], verts[1]);
+    RegularHexagon shuffled(verts);
+    EXPECT_FALSE(shuffled.isRegular());
+    EXPECT_TRUE(shuffled.getVertices() == verts);
+    EXPECT_FALSE(shuffled == RegularHexagon(Point(2, -1), 1.5, 0.3));
+    EXPECT_NEAR(shuffled.area(), Hexagon(verts).area(), 1e-12);
+
+    shuffled.setVertices(RegularHexagon(Point(2, -1), 1.5, 0.3).getVertices());
+    EXPECT_TRUE(shuffled.isRegular());
+
+    // Обычный шестиугольник формы не хранит
+    EXPECT_FALSE(Hexagon(shuffled.getVertices()).isRegular());
+}
+
+TEST(RegularFormTest, PublicTypesDetectOnCreate) {
+    std::vector<Point> verts;
+    for (int k = 0; k < 6; ++k) {
+        verts.push_back({2 + 1.5 * std::cos(0.3 + M_PI * k / 3), -1 + 1.5 * std::sin(0.3 + M_PI * k / 3)});
+    }
+
+    long long before = heapBytes;
+    Hexagon* hexagon = Hexagon::create(verts);
+    EXPECT_EQ(heapBytes - before, static_cast<long long>(sizeof(RegularHexagon)));
+    ASSERT_TRUE(hexagon->isRegular());
+    EXPECT_TRUE(*hexagon == Hexagon(verts));
+    delete hexagon;
+
+    Pentagon* pentagon = Pentagon::create({{0,0}, {1,0}, {1,1}, {0.5,1.5}, {0,1}});
+    EXPECT_FALSE(pentagon->isRegular());
+    EXPECT_EQ(typeid(*pentagon), typeid(Pentagon));
+    delete pentagon;
+
+    Octagon* octagon = Octagon::regular(Point(1, 1), 2.0, M_PI / 8);
+    ASSERT_TRUE(octagon->isRegular());
+    EXPECT_NEAR(octagon->area(), 8 * std::sqrt(2.0), 1e-12);
+    delete octagon;
+
+    EXPECT_THROW(Hexagon::create({{0,0}, {1,0}, {1,1}}), std::invalid_argument);
+
+    // Форма без числа сторон, флаг формы совмещен с состоянием кеша
+    EXPECT_EQ(sizeof(RegularForm), sizeof(Point) + 2 * sizeof(double));
+    EXPECT_LE(sizeof(RegularHexagon), sizeof(Hexagon) + sizeof(RegularForm) + sizeof(int64_t));
+}
+
+TEST(RegularFormTest, DetectedAtLargeCoordinates) {
+    for (double scale : {1e6, 1e9, 1e12}) {
+        Point center(scale, -2 * scale);
+        double radius = 10;
+        std::vector<Point> verts;
+        for (int k = 0; k < 8; ++k) {
+            double angle = 0.2 + M_PI * k / 4;
+            verts.push_back({center.x + radius * std::cos(angle), center.y + radius * std::sin(angle)});
+        }
+
+        std::unique_ptr<Octagon> octagon(Octagon::create(verts));
+        ASSERT_TRUE(octagon->isRegular()) << scale;
+        EXPECT_NEAR(octagon->regularForm()->radius, radius, 1e-14 * scale);
+        const auto& rebuilt = octagon->getVertices();
+        for (size_t k = 0; k < 8; ++k) {
+            EXPECT_NEAR(rebuilt[k].x, verts[k].x, 1e-14 * scale);
+            EXPECT_NEAR(rebuilt[k].y, verts[k].y, 1e-14 * scale);
+        }
+
+        // Отклонение заметно больше точности координат
+        verts[3].x += 1e-12 * scale;
+        EXPECT_FALSE(std::unique_ptr<Octagon>(Octagon::create(verts))->isRegular()) << scale;
+    }
+}
+
+TEST(RegularFormTest, IrregularFiguresDoNotPayForForm) {
+    EXPECT_EQ(sizeof(Pentagon), sizeof(void*) + sizeof(std::vector<Point>));
+    EXPECT_EQ(sizeof(Hexagon), sizeof(void*) + sizeof(std::vector<Point>));
+    EXPECT_EQ(sizeof(Octagon), sizeof(void*) + sizeof(std::vector<Point>));
+
+    Hexagon hexagon({{0,0}, {1,0}, {1,1}, {0,1}, {-0.5,0.5}, {-0.5,-0.5}});
+    EXPECT_EQ(hexagon.memoryUsage().liveBytes, sizeof(Hexagon) + 6 * sizeof(Point));
+
+    RegularHexagon regular(Point(0, 0), 1.0);
+    EXPECT_EQ(regular.memoryUsage().liveBytes, sizeof(RegularHexagon));
+    EXPECT_LT(regular.memoryUsage().total(), hexagon.memoryUsage().total());
+}
+
+TEST(RegularFormTest, CopyMoveAndArray) {
+    RegularOctagon octagon(Point(1, 1), 2.0);
+    RegularOctagon copy(octagon);
+    RegularOctagon moved(std::move(copy));
+    EXPECT_TRUE(moved.isRegular());
+    EXPECT_TRUE(moved == octagon);
+
+    // Обычная фигура получает построенные вершины
+    Octagon plain(octagon);
+    EXPECT_FALSE(plain.isRegular());
+    EXPECT_TRUE(plain == octagon);
+
+    RegularOctagon assigned({{0,0}, {1,0}, {1,1}, {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}});
+    EXPECT_FALSE(assigned.isRegular());
+    assigned = static_cast<const Figure&>(octagon);
+    EXPECT_TRUE(assigned.isRegular());
+    assigned = plain;
+    EXPECT_TRUE(assigned.isRegular());
+    EXPECT_THROW(assigned = RegularHexagon(Point(), 1.0), std::invalid_argument);
+
+    Array array;
+    array.addFigure(new RegularOctagon(octagon));
+    array.addFigure(new Pentagon({{0,0}, {1,0}, {1,1}, {0.5,1.5}, {0,1}}));
+    EXPECT_EQ(array.regularCount(), 1);
+    EXPECT_NEAR(array.totalArea(), octagon.area() + array[1]->area(), 1e-12);
+
+    array[0]->getVertices();
+    array.releaseVertexCaches();
+    EXPECT_EQ(array.memoryUsage().byType[typeid(RegularOctagon)].liveBytes, sizeof(RegularOctagon));
+}
+
+TEST(RegularFormTest, ConcurrentFirstAccess) {
+    for (int round = 0; round < 50; ++round) {
+        RegularHexagon hexagon(Point(round, 0), 1.0, 0.1);
+        std::vector<Point> expected;
+        for (size_t k = 0; k < 6; ++k) {
+            expected.push_back(hexagon.regularForm()->vertex(k, 6));
+        }
+
+        std::atomic<int> mismatches{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                if (!(hexagon.getVertices() == expected)) mismatches++;
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        EXPECT_EQ(mismatches, 0);
+    }
+}
+
 // ==================== CROSS-TYPE TESTS ====================
 
 TEST(CrossTypeTest, DifferentTypesNotEqual) {
@@ -432,6 +664,1403 @@ TEST_F(ArrayTest, PrintAllFigures) {
     EXPECT_NE(output.find("Hexagon"), std::string::npos);
 }
 
+TEST_F(ArrayTest, IteratorsAndView) {
+    Array array;
+    EXPECT_EQ(array.begin(), array.end());
+    EXPECT_TRUE(array.view().empty());
+
+    array.addFigure(new Octagon(octagon_vertices));
+    array.addFigure(new Pentagon(pentagon_vertices));
+    array.addFigure(new Hexagon(hexagon_vertices));
+
+    size_t count = 0;
+    for (Figure* figure : array) {
+        EXPECT_EQ(figure, array.get(count));
+        count++;
+    }
+    EXPECT_EQ(count, 3);
+
+    std::sort(array.begin(), array.end(), [](const Figure* a, const Figure* b) {
+        return a->area() < b->area();
+    });
+    EXPECT_TRUE(std::is_sorted(array.cbegin(), array.cend(), [](const Figure* a, const Figure* b) {
+        return a->area() < b->area();
+    }));
+
+    std::span<Figure* const> view = array.view();
+    ASSERT_EQ(view.size(), 3);
+    double total = std::transform_reduce(view.begin(), view.end(), 0.0, std::plus<>(),
+                                         [](const Figure* f) { return f->area(); });
+    EXPECT_NEAR(total, array.totalArea(), 1e-9);
+}
+
+TEST_F(ArrayTest, RemovedFiguresAreRecycled) {
+    Array array;
+    Hexagon* hexagon = new Hexagon(hexagon_vertices);
+    array.addFigure(hexagon);
+    array.addFigure(new Pentagon(pentagon_vertices));
+
+    array.removeFigure(0);
+    EXPECT_EQ(array.size(), 1);
+    EXPECT_EQ(array.pooledCount(), 1);
+
+    // Пул другого типа пуст - создается новая фигура
+    Pentagon* pentagon = array.acquire<Pentagon>();
+    EXPECT_TRUE(pentagon->getVertices().empty());
+    delete pentagon;
+
+    Hexagon* recycled = array.acquire<Hexagon>();
+    EXPECT_EQ(recycled, hexagon);
+    EXPECT_EQ(array.pooledCount(), 0);
+    // Вершины прежней фигуры удалены, память под них осталась
+    EXPECT_TRUE(recycled->getVertices().empty());
+    EXPECT_GE(recycled->getVertices().capacity(), 6);
+    recycled->setVertices(hexagon_vertices);
+    array.addFigure(recycled);
+
+    array.removeFigure(1);
+    array.releasePool();
+    EXPECT_EQ(array.pooledCount(), 0);
+}
+
+TEST_F(ArrayTest, PoolLimitIsRespected) {
+    Array array;
+    EXPECT_EQ(array.getPoolLimit(), Array::DEFAULT_POOL_LIMIT);
+    array.setPoolLimit(3);
+
+    for (int i = 0; i < 5; ++i) {
+        array.addFigure(new Hexagon(hexagon_vertices));
+        array.addFigure(new Pentagon(pentagon_vertices));
+    }
+    while (array.size() > 0) {
+        array.removeFigure(0);
+    }
+    // Лимит действует отдельно для каждого типа, лишние фигуры удалены
+    EXPECT_EQ(array.pooledCount(), 6);
+
+    array.setPoolLimit(1);
+    EXPECT_EQ(array.pooledCount(), 2);
+
+    array.setPoolLimit(0);
+    EXPECT_EQ(array.pooledCount(), 0);
+    array.addFigure(new Octagon(octagon_vertices));
+    // Без пула удаление не создает записей в таблице пулов
+    size_t before = allocationCount;
+    array.removeFigure(0);
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_EQ(array.pooledCount(), 0);
+}
+
+TEST_F(ArrayTest, SteadyStateChurnDoesNotAllocate) {
+    Array array;
+    for (int i = 0; i < 4; ++i) {
+        array.addFigure(new Hexagon(hexagon_vertices));
+    }
+
+    auto cycle = [&]() {
+        array.removeFigure(0);
+        Hexagon* hexagon = array.acquire<Hexagon>();
+        hexagon->setVertices(hexagon_vertices);
+        array.addFigure(hexagon);
+    };
+
+    // Первый цикл заводит пул
+    cycle();
+    size_t before = allocationCount;
+    for (int i = 0; i < 1000; ++i) {
+        cycle();
+    }
+    EXPECT_EQ(allocationCount - before, 0);
+    EXPECT_EQ(array.size(), 4);
+}
+
+TEST_F(ArrayTest, SortByMetric) {
+    Array array;
+    array.addFigure(new Octagon(octagon_vertices));
+    array.addFigure(new Pentagon(pentagon_vertices));
+    array.addFigure(new Hexagon(hexagon_vertices));
+
+    array.sortBy(Metric::Area);
+    EXPECT_TRUE(std::is_sorted(array.begin(), array.end(), [](const Figure* a, const Figure* b) {
+        return a->area() < b->area();
+    }));
+
+    array.sortBy(Metric::VertexCount, true);
+    EXPECT_EQ(array.get(0)->getVertices().size(), 8);
+    EXPECT_EQ(array.get(2)->getVertices().size(), 5);
+}
+
+TEST_F(ArrayTest, TopKByMetric) {
+    Array array;
+    for (int i = 0; i < 50; ++i) {
+        std::vector<Point> scaled;
+        double factor = 1 + (i * 37 % 50) * 0.1;
+        for (const auto& p : hexagon_vertices) {
+            scaled.push_back({p.x * factor, p.y * factor});
+        }
+        array.addFigure(new Hexagon(scaled));
+    }
+
+    std::vector<double> areas = array.metricColumn(Metric::Area);
+    std::vector<size_t> expected(areas.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(expected.begin(), expected.end(), [&](size_t a, size_t b) {
+        return areas[a] > areas[b];
+    });
+    expected.resize(5);
+
+    EXPECT_EQ(array.topK(Metric::Area, 5), expected);
+    EXPECT_EQ(array.topK(Metric::Area, 100).size(), 50);
+    EXPECT_TRUE(array.topK(Metric::Area, 0).empty());
+}
+
+TEST_F(ArrayTest, FigureMemoryUsage) {
+    Hexagon hexagon(hexagon_vertices);
+    MemoryUsage usage = hexagon.memoryUsage();
+
+    EXPECT_EQ(hexagon.objectSize(), sizeof(Hexagon));
+    EXPECT_EQ(usage.liveBytes, sizeof(Hexagon) + 6 * sizeof(Point));
+    EXPECT_EQ(usage.slackBytes, 0);
+    EXPECT_GT(usage.overheadBytes, 0);
+}
+
+TEST_F(ArrayTest, ArrayMemoryUsageMatchesHeap) {
+    long long before = heapBytes;
+    {
+        Array array;
+        for (int i = 0; i < 5; ++i) {
+            array.addFigure(new Pentagon(pentagon_vertices));
+            array.addFigure(new Octagon(octagon_vertices));
+        }
+        array.addFigure(new Hexagon(hexagon_vertices));
+
+        long long allocated = heapBytes - before;
+        ArrayMemoryUsage usage = array.memoryUsage();
+        // Байты, запрошенные у аллокатора, без его служебных данных
+        EXPECT_EQ(static_cast<long long>(usage.total.liveBytes + usage.total.slackBytes), allocated);
+        EXPECT_EQ(usage.pool.total(), 0);
+
+        array.removeFigure(0);
+        usage = array.memoryUsage();
+        EXPECT_EQ(usage.storage.liveBytes, 10 * sizeof(Figure*));
+        EXPECT_EQ(usage.storage.slackBytes, 6 * sizeof(Figure*));
+        EXPECT_EQ(usage.countByType[typeid(Pentagon)], 4);
+        EXPECT_EQ(usage.countByType[typeid(Octagon)], 5);
+        EXPECT_EQ(usage.byType[typeid(Octagon)].liveBytes, 5 * (sizeof(Octagon) + 8 * sizeof(Point)));
+        EXPECT_GE(usage.pool.slackBytes, sizeof(Pentagon) + 5 * sizeof(Point));
+    }
+    EXPECT_EQ(heapBytes, before);
+}
+
+TEST_F(ArrayTest, AggregateByType) {
+    Array array;
+    for (int i = 0; i < 4; ++i) {
+        array.addFigure(new RegularHexagon(Point(i, 0), 1.0 + i));
+    }
+    array.addFigure(new Pentagon(pentagon_vertices));
+    array.addFigure(new RegularPentagon(Point(10, 10), 5.0));
+
+    auto summary = array.aggregateByType(2.0, 5);
+    ASSERT_EQ(summary.size(), 2);
+    EXPECT_EQ(summary.count(typeid(Octagon)), 0);
+
+    const TypeSummary& hexagons = summary[typeid(Hexagon)];
+    EXPECT_EQ(hexagons.count, 4);
+    double total = 0;
+    std::vector<size_t> histogram(5, 0);
+    for (int i = 0; i < 4; ++i) {
+        double area = array[i]->area();
+        total += area;
+        histogram[std::min<size_t>(4, static_cast<size_t>(area / 2.0))]++;
+    }
+    EXPECT_NEAR(hexagons.totalArea, total, 1e-9);
+    EXPECT_NEAR(hexagons.meanArea, total / 4, 1e-9);
+    EXPECT_EQ(hexagons.histogram, histogram);
+    EXPECT_TRUE(hexagons.centroid == Point(1.5, 0));
+
+    const TypeSummary& pentagons = summary[typeid(Pentagon)];
+    EXPECT_EQ(pentagons.count, 2);
+    EXPECT_EQ(pentagons.histogram[4], 1);
+    EXPECT_NEAR(pentagons.totalArea, array.totalArea() - total, 1e-9);
+
+    EXPECT_THROW(array.aggregateByType(0), std::invalid_argument);
+    EXPECT_TRUE(Array().aggregateByType().empty());
+}
+
+TEST_F(ArrayTest, AggregateByTypeClampsHugeAreasAndRejectsNaN) {
+    Array array;
+    array.addFigure(new Hexagon(hexagon_vertices));
+    array.addFigure(new RegularHexagon(Point(0, 0), 1e200));
+
+    // Частное больше SIZE_MAX и бесконечная площадь попадают в последнюю корзину
+    auto summary = array.aggregateByType(1e-300, 3);
+    EXPECT_EQ(summary[typeid(Hexagon)].histogram, (std::vector<size_t>{0, 0, 2}));
+
+    array.addFigure(new Hexagon({{0,0}, {1,0}, {std::nan(""),1}, {1,2}, {0,2}, {-1,1}}));
+    EXPECT_THROW(array.aggregateByType(), std::invalid_argument);
+}
+
+// ==================== COMPACT ARRAY TESTS ====================
+
+class CompactArrayTest : public ArrayTest {
+protected:
+    void fill(Array& array, Point offset) {
+        for (auto* verts : {&pentagon_vertices, &hexagon_vertices, &octagon_vertices}) {
+            std::vector<Point> shifted;
+            for (const auto& p : *verts) {
+                shifted.push_back({p.x * 3.7 + offset.x, p.y * 2.1 + offset.y});
+            }
+            array.addFigure(createFigure(shifted));
+        }
+    }
+
+    // Сравнивает центр и площадь компактной копии с double-версией
+    void expectMatches(const Array& array, const CompactArray& compact, double coordError) {
+        ASSERT_EQ(compact.size(), array.size());
+        for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+            Point expected = array[i]->center();
+            Point actual = compact.center(i);
+            EXPECT_NEAR(actual.x, expected.x, coordError);
+            EXPECT_NEAR(actual.y, expected.y, coordError);
+
+            double perimeter = 0;
+            const auto& verts = array[i]->getVertices();
+            for (size_t k = 0; k < verts.size(); ++k) {
+                const Point& a = verts[k];
+                const Point& b = verts[(k + 1) % verts.size()];
+                perimeter += std::hypot(a.x - b.x, a.y - b.y);
+            }
+            EXPECT_NEAR(compact.area(i), array[i]->area(), 2 * perimeter * coordError);
+        }
+    }
+};
+
+TEST_F(CompactArrayTest, Float32MatchesDoublePath) {
+    Array array;
+    fill(array, {1000.25, -500.5});
+
+    CompactArray compact(CompactArray::Encoding::Float32, Point(1000, -500));
+    compact.addFigures(array);
+
+    expectMatches(array, compact, compact.maxCoordinateError(10.0));
+    EXPECT_NEAR(compact.totalArea(), array.totalArea(), 1e-4);
+}
+
+TEST_F(CompactArrayTest, Fixed32MatchesDoublePath) {
+    Array array;
+    fill(array, {123456.789, 42.0});
+
+    CompactArray compact(CompactArray::Encoding::Fixed32, Point(123456, 0), 1e-4);
+    compact.addFigures(array);
+
+    expectMatches(array, compact, compact.maxCoordinateError(0));
+    EXPECT_DOUBLE_EQ(compact.maxCoordinateError(0), 5e-5);
+}
+
+TEST_F(CompactArrayTest, RoundTripToArray) {
+    Array array;
+    fill(array, {0, 0});
+
+    CompactArray compact(CompactArray::Encoding::Fixed32, Point(), 1e-7);
+    compact.addFigures(array);
+    Array restored = compact.toArray();
+
+    ASSERT_EQ(restored.size(), array.size());
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        EXPECT_TRUE(*restored[i] == *array[i]);
+    }
+}
+
+TEST_F(CompactArrayTest, Fixed32RangeAndIndexChecks) {
+    CompactArray compact(CompactArray::Encoding::Fixed32, Point(), 1e-6);
+    EXPECT_THROW(compact.addFigure(Pentagon({{0,0}, {1e6,0}, {1,1}, {0.5,1.5}, {0,1}})), std::out_of_range);
+    EXPECT_EQ(compact.size(), 0);
+    EXPECT_THROW(compact.area(0), std::out_of_range);
+    EXPECT_THROW(CompactArray(CompactArray::Encoding::Fixed32, Point(), 0), std::invalid_argument);
+}
+
+TEST(FactoryTest, CreatesFigureByVertexCount) {
+    Figure* figure = createFigure(std::vector<Point>(6, {0, 0}));
+    EXPECT_NE(dynamic_cast<Hexagon*>(figure), nullptr);
+    delete figure;
+
+    EXPECT_THROW(createFigure(std::vector<Point>(7, {0, 0})), std::invalid_argument);
+}
+
+// ==================== PAGED ARRAY TESTS ====================
+
+// 25 фигур трех типов, сдвинутых по X
+class MixedArrayTest : public ArrayTest {
+protected:
+    void SetUp() override {
+        ArrayTest::SetUp();
+        for (int i = 0; i < 25; ++i) {
+            auto verts = (i % 3 == 0) ? pentagon_vertices : (i % 3 == 1) ? hexagon_vertices : octagon_vertices;
+            for (auto& p : verts) {
+                p.x += i;
+            }
+            array.addFigure(createFigure(verts));
+        }
+    }
+
+    Array array;
+};
+
+class PagedArrayTest : public MixedArrayTest {
+protected:
+    void SetUp() override {
+        MixedArrayTest::SetUp();
+        PagedArray::write(path, array, 4);
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    std::string path = "paged_array_test.bin";
+};
+
+TEST_F(PagedArrayTest, SameSemanticsAsArray) {
+    PagedArray paged(path, 2);
+
+    ASSERT_EQ(paged.size(), array.size());
+    EXPECT_EQ(paged.chunkSize(), 4);
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        EXPECT_TRUE(*paged[i] == *array[i]);
+    }
+    EXPECT_NEAR(paged.totalArea(), array.totalArea(), 1e-9);
+
+    std::stringstream expected, actual;
+    array.printAllFigures(expected);
+    paged.printAllFigures(actual);
+    EXPECT_EQ(actual.str(), expected.str());
+
+    EXPECT_THROW(paged[-1], std::out_of_range);
+    EXPECT_THROW(paged[25], std::out_of_range);
+}
+
+TEST_F(PagedArrayTest, CacheIsBounded) {
+    PagedArray paged(path, 2);
+
+    // Фигура остается доступной после вытеснения ее куска
+    auto first = paged[0];
+    for (int i = 24; i >= 0; --i) {
+        paged[i];
+        EXPECT_LE(paged.cachedChunks(), 2);
+    }
+    EXPECT_TRUE(*first == *array[0]);
+}
+
+TEST_F(PagedArrayTest, MoveDuringReadAhead) {
+    auto source = std::make_unique<PagedArray>(path, 2);
+    (*source)[0];
+    (*source)[4];  // запускает фоновое чтение куска 2
+
+    PagedArray moved(std::move(*source));
+    source.reset();
+    for (int i = 8; i < 25; ++i) {
+        EXPECT_TRUE(*moved[i] == *array[i]);
+    }
+}
+
+TEST(PagedArrayErrors, InvalidFiles) {
+    EXPECT_THROW(PagedArray("missing_paged_file.bin"), std::runtime_error);
+
+    Array array;
+    EXPECT_THROW(PagedArray::write("paged_empty.bin", array, 0), std::invalid_argument);
+    PagedArray::write("paged_empty.bin", array);
+    PagedArray empty("paged_empty.bin");
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_DOUBLE_EQ(empty.totalArea(), 0);
+    std::remove("paged_empty.bin");
+
+    // Фигура без вершин не пишется, а не ломает чтение куска позже
+    array.addFigure(new Hexagon());
+    EXPECT_THROW(PagedArray::write("paged_invalid.bin", array), std::invalid_argument);
+    std::remove("paged_invalid.bin");
+}
+
+// ==================== ARCHIVE TESTS ====================
+
+class ArchiveRoundTripTest : public MixedArrayTest {};
+
+TEST_F(ArchiveRoundTripTest, RestoresAllFigures) {
+    std::stringstream archive;
+    Archive::write(archive, array, 4);
+
+    std::stringstream text;
+    array.printAllFigures(text);
+    EXPECT_LT(archive.str().size(), text.str().size() / 3);
+
+    Array restored = Archive::read(archive);
+    ASSERT_EQ(restored.size(), array.size());
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        EXPECT_TRUE(*restored[i] == *array[i]);
+    }
+}
+
+TEST(ArchiveTest, QuantizationWithinPointTolerance) {
+    Array array;
+    array.addFigure(new Pentagon({{0.1234567891,-3.3333333333}, {1e5 + 0.4999999,0}, {1,1}, {-7.77777777,1.5}, {0,-1e-7}}));
+
+    std::stringstream archive;
+    Archive::write(archive, array);
+    Array restored = Archive::read(archive);
+
+    ASSERT_EQ(restored.size(), 1);
+    const auto& expected = array[0]->getVertices();
+    const auto& actual = restored[0]->getVertices();
+    for (size_t k = 0; k < expected.size(); ++k) {
+        EXPECT_LE(std::abs(actual[k].x - expected[k].x), Archive::QUANTUM / 2 + 1e-12);
+        EXPECT_LE(std::abs(actual[k].y - expected[k].y), Archive::QUANTUM / 2 + 1e-12);
+    }
+}
+
+TEST(ArchiveTest, CorruptedInputThrows) {
+    std::stringstream garbage("not an archive");
+    EXPECT_THROW(Archive::read(garbage), std::runtime_error);
+
+    Array array;
+    array.addFigure(new Hexagon({{0,0}, {1,0}, {1,1}, {0,1}, {-0.5,0.5}, {-0.5,-0.5}}));
+    std::stringstream archive;
+    Archive::write(archive, array);
+
+    std::string bytes = archive.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 3));
+    EXPECT_THROW(Archive::read(truncated), std::runtime_error);
+}
+
+// ==================== CONCURRENT ARRAY TESTS ====================
+
+TEST_F(ArrayTest, ConcurrentArraySnapshotIsImmutable) {
+    ConcurrentArray array;
+    array.addFigure(new Pentagon(pentagon_vertices));
+    array.addFigure(new Hexagon(hexagon_vertices));
+
+    ConcurrentArray::Snapshot before = array.snapshot();
+    const Figure* removed = before[0];
+
+    array.removeFigure(0);
+    array.addFigure(new Octagon(octagon_vertices));
+
+    // Старый снимок видит прежнее состояние, удаленная фигура жива
+    ASSERT_EQ(before.size(), 2);
+    EXPECT_TRUE(*removed == Pentagon(pentagon_vertices));
+    EXPECT_NEAR(before.totalArea(), Pentagon(pentagon_vertices).area() + Hexagon(hexagon_vertices).area(), 1e-9);
+
+    ConcurrentArray::Snapshot after = array.snapshot();
+    ASSERT_EQ(after.size(), 2);
+    EXPECT_TRUE(*after[1] == Octagon(octagon_vertices));
+    EXPECT_THROW(after[2], std::out_of_range);
+    EXPECT_THROW(array.removeFigure(5), std::out_of_range);
+    EXPECT_THROW(array.addFigure(nullptr), std::invalid_argument);
+}
+
+TEST_F(ArrayTest, ConcurrentArrayBatchAdd) {
+    ConcurrentArray array;
+    array.addFigure(new Pentagon(pentagon_vertices));
+    ConcurrentArray::Snapshot before = array.snapshot();
+
+    array.addFigures({new Hexagon(hexagon_vertices), new Octagon(octagon_vertices)});
+    EXPECT_EQ(before.size(), 1);
+
+    ConcurrentArray::Snapshot after = array.snapshot();
+    ASSERT_EQ(after.size(), 3);
+    EXPECT_TRUE(*after[0] == Pentagon(pentagon_vertices));
+    EXPECT_TRUE(*after[1] == Hexagon(hexagon_vertices));
+    EXPECT_TRUE(*after[2] == Octagon(octagon_vertices));
+    EXPECT_THROW(array.addFigures({nullptr}), std::invalid_argument);
+    EXPECT_EQ(array.size(), 3);
+
+    // При ошибке переданные фигуры удаляются, а не теряются
+    long long heapBefore = heapBytes;
+    EXPECT_THROW(array.addFigures({new Hexagon(hexagon_vertices), nullptr}), std::invalid_argument);
+    EXPECT_EQ(heapBytes, heapBefore);
+    EXPECT_EQ(array.size(), 3);
+}
+
+TEST_F(ArrayTest, ConcurrentReadersAndWriter) {
+    ConcurrentArray array;
+    double area = Hexagon(hexagon_vertices).area();
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done) {
+                ConcurrentArray::Snapshot snapshot = array.snapshot();
+                if (std::abs(snapshot.totalArea() - snapshot.size() * area) > 1e-6) {
+                    inconsistent++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+        array.addFigure(new Hexagon(hexagon_vertices));
+        if (i % 3 == 0) {
+            array.removeFigure(0);
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(inconsistent, 0);
+    EXPECT_EQ(array.size(), 2000 - 667);
+}
+
+// ==================== QUERY TESTS ====================
+
+TEST_F(ArrayTest, FigureQueryFilters) {
+    Array array;
+    for (int i = 0; i < 30; ++i) {
+        auto verts = (i % 3 == 0) ? pentagon_vertices : (i % 3 == 1) ? hexagon_vertices : octagon_vertices;
+        double factor = 1 + i * 0.1;
+        for (auto& p : verts) {
+            p = Point(p.x * factor + i, p.y * factor);
+        }
+        array.addFigure(createFigure(verts));
+    }
+
+    BoundingBox box(5, -10, 20, 10);
+    FigureQuery query(array);
+    query.ofType<Hexagon>().areaAbove(3.0).centerIn(box);
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < array.size(); ++i) {
+        const Figure* f = array.get(i);
+        if (dynamic_cast<const Hexagon*>(f) && f->area() > 3.0 && box.contains(f->center())) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(query.indices(), expected);
+    EXPECT_EQ(query.count(), expected.size());
+
+    std::vector<uint8_t> selection = query.selection();
+    ASSERT_EQ(selection.size(), array.size());
+    for (size_t i : expected) {
+        EXPECT_EQ(selection[i], 1);
+    }
+
+    query.reset().intersects(BoundingBox(-100, -100, 0.4, 100)).areaBelow(100);
+    EXPECT_EQ(query.indices(), (std::vector<size_t>{0}));
+
+    query.reset().ofType(typeid(int));
+    EXPECT_EQ(query.count(), 0);
+    EXPECT_EQ(query.reset().count(), array.size());
+}
+
+// Отдельный тип фигуры на каждое N
+template <size_t N>
+class TaggedPentagon : public Pentagon {
+public:
+    using Pentagon::Pentagon;
+};
+
+template <size_t... N>
+void addTaggedPentagons(Array& array, const std::vector<Point>& vertices, std::index_sequence<N...>) {
+    (array.addFigure(new TaggedPentagon<N>(vertices)), ...);
+}
+
+TEST_F(ArrayTest, FigureQueryRejectsTooManyTypes) {
+    Array array;
+    addTaggedPentagons(array, pentagon_vertices, std::make_index_sequence<255>());
+    FigureQuery query(array);
+    EXPECT_EQ(query.ofType<TaggedPentagon<254>>().count(), 1);
+
+    array.addFigure(new Hexagon(hexagon_vertices));
+    EXPECT_THROW(FigureQuery{array}, std::length_error);
+}
+
+// ==================== TRACE TESTS ====================
+
+TEST(TraceTest, ScopesRecordOnlyWhenEnabled) {
+    Trace::reset();
+    Trace::setEnabled(false);
+    {
+        TraceScope scope("disabled");
+    }
+    EXPECT_EQ(Trace::eventCount(), 0);
+
+    Trace::setEnabled(true);
+    {
+        TraceScope scope("enabled");
+    }
+    std::thread([] { TraceScope scope("worker"); }).join();
+    Trace::setEnabled(false);
+    EXPECT_EQ(Trace::eventCount(), 2);
+
+    std::stringstream ss;
+    Trace::dump(ss);
+    std::string json = ss.str();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+    EXPECT_NE(json.find("\"name\":\"enabled\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"worker\""), std::string::npos);
+    EXPECT_EQ(json.find("disabled"), std::string::npos);
+
+    // Время не теряет точности: поток запущен после первой области
+    auto timestamp = [&](const std::string& name) {
+        size_t event = json.find("\"name\":\"" + name + "\"");
+        size_t ts = json.find("\"ts\":", event);
+        return std::stod(json.substr(ts + 5));
+    };
+    double enabledTs = timestamp("enabled"), workerTs = timestamp("worker");
+    EXPECT_EQ(json.find("e+"), std::string::npos);
+    EXPECT_LT(enabledTs, workerTs);
+    Trace::reset();
+}
+
+TEST(TraceTest, RingBufferKeepsLatestEvents) {
+    Trace::reset();
+    Trace::setEnabled(true);
+    for (size_t i = 0; i < Trace::BUFFER_EVENTS + 10; ++i) {
+        TraceScope scope("loop");
+    }
+    Trace::setEnabled(false);
+    EXPECT_EQ(Trace::eventCount(), Trace::BUFFER_EVENTS);
+    Trace::reset();
+}
+
+TEST(TraceTest, ExitedThreadBuffersAreReused) {
+    Trace::reset();
+    Trace::setEnabled(true);
+    std::thread([] { TraceScope scope("first"); }).join();
+    size_t buffersBefore = Trace::bufferCount();
+    for (int i = 0; i < 50; ++i) {
+        std::thread([] { TraceScope scope("short"); }).join();
+    }
+    Trace::setEnabled(false);
+    EXPECT_EQ(Trace::bufferCount(), buffersBefore);
+    // События завершившихся потоков не теряются
+    EXPECT_EQ(Trace::eventCount(), 51);
+    Trace::reset();
+}
+
+TEST(TraceTest, DumpAndResetWhileRecording) {
+    Trace::reset();
+    Trace::setEnabled(true);
+    std::atomic<bool> running{true};
+    std::thread writer([&] {
+        while (running.load()) {
+            TraceScope scope("busy");
+        }
+    });
+    for (int i = 0; i < 100; ++i) {
+        std::stringstream ss;
+        Trace::dump(ss);
+        std::string json = ss.str();
+        EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+        EXPECT_EQ(json.substr(json.size() - 2), "}\n");
+        Trace::reset();
+    }
+    running.store(false);
+    writer.join();
+    Trace::setEnabled(false);
+    EXPECT_LE(Trace::eventCount(), Trace::BUFFER_EVENTS);
+    Trace::reset();
+}
+
+#ifdef FIGURES_TRACING
+TEST_F(ArrayTest, ArrayOperationsAreTraced) {
+    Trace::reset();
+    Trace::setEnabled(true);
+    Array array;
+    array.addFigure(new Pentagon(pentagon_vertices));
+    array.totalArea();
+
+    std::stringstream input;
+    for (const auto& p : pentagon_vertices) input << p.x << ' ' << p.y << ' ';
+    for (const auto& p : hexagon_vertices) input << p.x << ' ' << p.y << ' ';
+    for (const auto& p : octagon_vertices) input << p.x << ' ' << p.y << ' ';
+    Pentagon pentagon;
+    Hexagon hexagon;
+    Octagon octagon;
+    input >> pentagon >> hexagon >> octagon;
+    Trace::setEnabled(false);
+    EXPECT_EQ(hexagon, Hexagon(hexagon_vertices));
+
+    std::stringstream ss;
+    Trace::dump(ss);
+    EXPECT_NE(ss.str().find("Array::addFigure"), std::string::npos);
+    EXPECT_NE(ss.str().find("Array::resize"), std::string::npos);
+    EXPECT_NE(ss.str().find("Array::totalArea"), std::string::npos);
+    EXPECT_NE(ss.str().find("Pentagon::read"), std::string::npos);
+    EXPECT_NE(ss.str().find("Hexagon::read"), std::string::npos);
+    EXPECT_NE(ss.str().find("Octagon::read"), std::string::npos);
+    Trace::reset();
+}
+#endif
+
+// ==================== INTERNED ARRAY TESTS ====================
+
+TEST(InternedArrayTest, SharedVerticesStoredOnce) {
+    // Полоса из квадратных шестиугольников с общими сторонами
+    Array array;
+    for (int i = 0; i < 10; ++i) {
+        double x = i;
+        array.addFigure(new Hexagon({{x,0}, {x + 0.5,0}, {x + 1,0}, {x + 1,1}, {x + 0.5,1}, {x + 3e-7,1}}));
+    }
+
+    InternedArray interned;
+    interned.addFigures(array);
+
+    ASSERT_EQ(interned.size(), 10);
+    EXPECT_EQ(interned.poolSize(), 10 * 4 + 2);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(interned.vertexCount(i), 6);
+        EXPECT_TRUE(*array[i] == Hexagon(interned.getVertices(i)));
+        EXPECT_NEAR(interned.area(i), array[i]->area(), 1e-5);
+        EXPECT_TRUE(interned.center(i) == array[i]->center());
+    }
+    EXPECT_NEAR(interned.totalArea(), array.totalArea(), 1e-4);
+    EXPECT_THROW(interned.center(10), std::out_of_range);
+}
+
+TEST(InternedArrayTest, TranslateMovesSharedVerticesOnce) {
+    InternedArray interned;
+    interned.addFigure(Pentagon({{0,0}, {1,0}, {1,1}, {0.5,1.5}, {0,1}}));
+    interned.addFigure(Pentagon({{1,0}, {2,0}, {2,1}, {1.5,1.5}, {1,1}}));
+    EXPECT_EQ(interned.poolSize(), 8);
+
+    size_t calls = 0;
+    interned.transform([&](const Point& p) {
+        calls++;
+        return Point(p.x * 2, p.y);
+    });
+    EXPECT_EQ(calls, 8);
+
+    interned.translate(1, 1);
+    Array restored = interned.toArray();
+    ASSERT_EQ(restored.size(), 2);
+    EXPECT_TRUE(restored[1]->getVertices()[0] == Point(3, 1));
+
+    // После преобразования пул продолжает находить совпадения
+    interned.addFigure(Pentagon({{3,1}, {5,1}, {5,2}, {4,2.5}, {3,2}}));
+    EXPECT_EQ(interned.poolSize(), 8);
+}
+
+TEST(InternedArrayTest, SmallerThanArrayOnSharedVertexTiling) {
+    // Решетка шестиугольников: углы общие для четырех фигур, середины сторон - для двух
+    long long before = heapBytes;
+    Array array;
+    for (int i = 0; i < 40; ++i) {
+        for (int j = 0; j < 40; ++j) {
+            double x = i, y = j;
+            array.addFigure(new Hexagon({{x,y}, {x + 0.5,y}, {x + 1,y}, {x + 1,y + 1}, {x + 0.5,y + 1}, {x,y + 1}}));
+        }
+    }
+    long long arrayBytes = heapBytes - before;
+
+    before = heapBytes;
+    {
+        InternedArray interned;
+        interned.addFigures(array);
+        interned.shrink();
+        long long internedBytes = heapBytes - before;
+
+        EXPECT_EQ(interned.poolSize(), 41 * 41 + 40 * 41);
+        EXPECT_LT(internedBytes, arrayBytes / 2);
+
+        // После shrink() добавление по-прежнему находит общие вершины
+        interned.addFigure(*array[0]);
+        EXPECT_EQ(interned.poolSize(), 41 * 41 + 40 * 41);
+        EXPECT_TRUE(Hexagon(interned.getVertices(1600)) == *array[0]);
+    }
+    EXPECT_EQ(heapBytes - before, 0);
+}
+
+TEST(InternedArrayTest, RejectsHugeCoordinatesWithoutPartialFigure) {
+    InternedArray interned;
+    Hexagon square({{0,0}, {0.5,0}, {1,0}, {1,1}, {0.5,1}, {0,1}});
+    interned.addFigure(square);
+
+    // Первые вершины новые, последняя не помещается в сетку
+    Hexagon huge({{5,5}, {6,5}, {7,5}, {7,6}, {6,6}, {1e13,6}});
+    EXPECT_THROW(interned.addFigure(huge), std::out_of_range);
+    Hexagon nan({{5,5}, {6,5}, {7,5}, {7,6}, {6,6}, {std::nan(""),6}});
+    EXPECT_THROW(interned.addFigure(nan), std::out_of_range);
+    EXPECT_EQ(interned.size(), 1);
+    EXPECT_EQ(interned.poolSize(), 6);
+
+    interned.addFigure(square);
+    EXPECT_EQ(interned.size(), 2);
+    EXPECT_EQ(interned.poolSize(), 6);
+    EXPECT_TRUE(Hexagon(interned.getVertices(1)) == square);
+}
+
+// ==================== DIFF TESTS ====================
+
+TEST_F(ArrayTest, DiffFindsAddedRemovedAndUnchanged) {
+    Array before, after;
+    before.addFigure(new Pentagon(pentagon_vertices));
+    before.addFigure(new Hexagon(hexagon_vertices));
+    before.addFigure(new Octagon(octagon_vertices));
+    before.addFigure(new Pentagon(pentagon_vertices));
+
+    // Сдвиг меньше допуска не считается изменением
+    std::vector<Point> nudged = hexagon_vertices;
+    for (auto& p : nudged) {
+        p.x += 4e-7;
+    }
+    after.addFigure(new Hexagon(nudged));
+    after.addFigure(new Pentagon(pentagon_vertices));
+    after.addFigure(new Octagon({{5,0}, {6,0}, {6,1}, {5,1}, {4,1}, {4,0}, {4,-1}, {5,-1}}));
+
+    ArrayDiff result = diff(before, after);
+
+    std::vector<std::pair<size_t, size_t>> unchanged = {{1, 0}, {0, 1}};
+    EXPECT_EQ(result.unchanged, unchanged);
+    EXPECT_EQ(result.added, (std::vector<size_t>{2}));
+    EXPECT_EQ(result.removed, (std::vector<size_t>{2, 3}));
+}
+
+TEST_F(ArrayTest, DiffDistinguishesTypesWithSameCenter) {
+    Array before, after;
+    before.addFigure(new Hexagon({{1,0}, {0.5,1}, {-0.5,1}, {-1,0}, {-0.5,-1}, {0.5,-1}}));
+    after.addFigure(new Octagon({{1,0}, {1,1}, {0,1}, {-1,1}, {-1,0}, {-1,-1}, {0,-1}, {1,-1}}));
+
+    ArrayDiff result = diff(before, after);
+    EXPECT_TRUE(result.unchanged.empty());
+    EXPECT_EQ(result.added.size(), 1);
+    EXPECT_EQ(result.removed.size(), 1);
+}
+
+namespace {
+
+size_t diffComparisons = 0;
+
+class CountingPentagon : public Pentagon {
+public:
+    using Pentagon::Pentagon;
+
+    bool operator==(const Figure& other) const override {
+        diffComparisons++;
+        return Pentagon::operator==(other);
+    }
+};
+
+}
+
+TEST_F(ArrayTest, DiffMatchesDuplicatesInLinearComparisons) {
+    // Две формы с общим центром, чередуются, по 1000 копий каждой
+    std::vector<Point> rotated;
+    for (const auto& p : pentagon_vertices) {
+        rotated.push_back(Point(-p.x, -p.y));
+    }
+    Array before, after;
+    for (int i = 0; i < 2000; ++i) {
+        before.addFigure(new CountingPentagon(i % 2 ? rotated : pentagon_vertices));
+        after.addFigure(new CountingPentagon(i % 2 ? rotated : pentagon_vertices));
+    }
+
+    diffComparisons = 0;
+    ArrayDiff result = diff(before, after);
+    EXPECT_LT(diffComparisons, 5 * 2000);
+    ASSERT_EQ(result.unchanged.size(), 2000);
+    for (size_t i = 0; i < 2000; ++i) {
+        EXPECT_EQ(result.unchanged[i], std::make_pair(i, i));
+    }
+    EXPECT_TRUE(result.added.empty());
+    EXPECT_TRUE(result.removed.empty());
+}
+
+TEST_F(ArrayTest, DiffRejectsCentersOutsideGrid) {
+    Array before, after;
+    before.addFigure(new Hexagon(hexagon_vertices));
+    after.addFigure(new Hexagon({{1e13,0}, {1e13,1}, {1e13,2}, {1e13 + 1,2}, {1e13 + 1,1}, {1e13 + 1,0}}));
+    EXPECT_THROW(diff(before, after), std::out_of_range);
+    EXPECT_THROW(diff(after, before), std::out_of_range);
+}
+
+// ==================== LOADER TESTS ====================
+
+class LoaderTest : public MixedArrayTest {
+protected:
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    std::string path = "loader_test.txt";
+};
+
+TEST_F(LoaderTest, PipelinedLoadRoundTrip) {
+    array.addFigure(new RegularHexagon(Point(0.1, -0.2), 1.0 / 3));
+    {
+        std::ofstream out(path);
+        saveDataset(out, array);
+        out << "\n   \n";
+    }
+
+    // Маленький блок, чтобы строки разрезались между блоками
+    LoadResult loaded = loadDataset(path, 7);
+
+    ASSERT_EQ(loaded.figures.size(), array.size());
+    ASSERT_EQ(loaded.areas.size(), array.size());
+    ASSERT_EQ(loaded.centers.size(), array.size());
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        EXPECT_TRUE(*loaded.figures[i] == *array[i]);
+        EXPECT_NEAR(loaded.areas[i], array[i]->area(), 1e-12);
+        EXPECT_TRUE(loaded.centers[i] == array[i]->center());
+    }
+    EXPECT_TRUE(loaded.figures[25]->isRegular());
+}
+
+TEST_F(LoaderTest, PipelinedLoadReportsErrors) {
+    {
+        std::ofstream out(path);
+        out << "Pentagon 0 0 1 0 1 1 0.5 1.5 0 1\n";
+        out << "Hexagon 0 0 1 0 1 1\n";
+    }
+    try {
+        loadDataset(path, 5);
+        FAIL() << "expected parse error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()), "Invalid figure at line 2");
+    }
+
+    {
+        std::ofstream out(path);
+        out << "Triangle 0 0 1 0 1 1\n";
+    }
+    EXPECT_THROW(loadDataset(path), std::runtime_error);
+    EXPECT_THROW(loadDataset("missing_dataset.txt"), std::runtime_error);
+}
+
+// ==================== AREA PYRAMID TESTS ====================
+
+class AreaPyramidTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (int i = 0; i < 200; ++i) {
+            double x = (i * 37 % 101) * 0.5, y = (i * 53 % 97) * 0.5;
+            array.addFigure(new RegularHexagon(Point(x, y), 0.2 + (i % 7) * 0.1));
+        }
+    }
+
+    AreaPyramid::RegionTotal bruteForce(const BoundingBox& region) const {
+        AreaPyramid::RegionTotal total;
+        for (const Figure* figure : array) {
+            if (region.contains(figure->center())) {
+                total.count++;
+                total.area += figure->area();
+            }
+        }
+        return total;
+    }
+
+    void expectMatches(const AreaPyramid& pyramid) const {
+        for (double x0 = -5; x0 < 50; x0 += 6.3) {
+            for (double y0 = -5; y0 < 50; y0 += 7.1) {
+                BoundingBox region(x0, y0, x0 + 13.7, y0 + 9.2);
+                auto expected = bruteForce(region);
+                auto actual = pyramid.query(region);
+                EXPECT_EQ(actual.count, expected.count);
+                EXPECT_NEAR(actual.area, expected.area, 1e-9);
+            }
+        }
+    }
+
+    Array array;
+};
+
+TEST_F(AreaPyramidTest, RegionTotalsMatchFullScan) {
+    AreaPyramid pyramid(array, 5);
+    EXPECT_EQ(pyramid.size(), array.size());
+    expectMatches(pyramid);
+
+    auto all = pyramid.query(BoundingBox(-100, -100, 100, 100));
+    EXPECT_EQ(all.count, array.size());
+    EXPECT_NEAR(all.area, array.totalArea(), 1e-9);
+}
+
+TEST_F(AreaPyramidTest, IncrementalUpdates) {
+    AreaPyramid pyramid(BoundingBox(0, 0, 40, 40), 4);
+    for (const Figure* figure : array) {
+        pyramid.add(figure);
+    }
+    expectMatches(pyramid);
+
+    for (int i = 0; i < 50; ++i) {
+        pyramid.remove(array[0]);
+        array.removeFigure(0);
+    }
+    array.addFigure(new RegularOctagon(Point(-3, -3), 1.0));
+    pyramid.add(array[static_cast<int>(array.size()) - 1]);
+
+    EXPECT_EQ(pyramid.size(), array.size());
+    expectMatches(pyramid);
+
+    EXPECT_THROW(pyramid.add(array[0]), std::invalid_argument);
+    RegularHexagon stranger(Point(1, 1), 1.0);
+    EXPECT_THROW(pyramid.remove(&stranger), std::invalid_argument);
+    EXPECT_THROW(AreaPyramid(BoundingBox(0, 0, 0, 1)), std::invalid_argument);
+}
+
+TEST_F(AreaPyramidTest, AttachedPyramidFollowsArray) {
+    auto pyramid = AreaPyramid::attach(array, 5);
+    EXPECT_EQ(pyramid->size(), array.size());
+
+    // Удаленные фигуры возвращаются из пула по тем же адресам
+    for (int i = 0; i < 30; ++i) {
+        array.removeFigure(i);
+        RegularHexagon* recycled = array.acquire<RegularHexagon>();
+        recycled->setVertices(RegularHexagon(Point(i, 40 - i), 0.5 + i * 0.05).getVertices());
+        array.addFigure(recycled);
+    }
+    EXPECT_EQ(pyramid->size(), array.size());
+    expectMatches(*pyramid);
+
+    Array moved(std::move(array));
+    moved.removeFigure(0);
+    EXPECT_EQ(pyramid->size(), moved.size());
+
+    moved.clear();
+    EXPECT_EQ(pyramid->size(), 0);
+    EXPECT_EQ(pyramid->query(BoundingBox(-100, -100, 100, 100)).count, 0);
+}
+
+TEST_F(AreaPyramidTest, BoundsFollowFiguresOutside) {
+    // Массив растет далеко за первоначальные bounds
+    Array grown;
+    auto pyramid = AreaPyramid::attach(grown, 5);
+    for (int i = 0; i < 2000; ++i) {
+        double x = (i * 37 % 101) * 0.05 * (1 + i / 100), y = (i * 53 % 97) * 0.05 * (1 + i / 100);
+        grown.addFigure(new RegularHexagon(Point(x, y), 0.1));
+    }
+    EXPECT_LT(pyramid->outsideCount(), grown.size() / 2);
+
+    for (double size : {3.0, 20.0, 200.0}) {
+        BoundingBox region(1, 1, 1 + size, 1 + size);
+        size_t expected = 0;
+        for (const Figure* figure : grown) {
+            expected += region.contains(figure->center());
+        }
+        EXPECT_EQ(pyramid->query(region).count, expected);
+    }
+}
+
+namespace {
+
+class RejectingObserver : public ArrayObserver {
+public:
+    void figureAdded(const Figure*) override {}
+
+    void figureRemoved(const Figure*) override {
+        throw std::runtime_error("Removal rejected");
+    }
+
+    void cleared() noexcept override {}
+};
+
+}
+
+TEST_F(AreaPyramidTest, ObserverFailureLeavesArrayUnchanged) {
+    static_assert(noexcept(std::declval<ArrayObserver&>().cleared()));
+
+    Figure* first = array[0];
+    size_t before = array.size();
+    array.setObserver(std::make_shared<RejectingObserver>());
+    EXPECT_THROW(array.removeFigure(0), std::runtime_error);
+    EXPECT_EQ(array.size(), before);
+    EXPECT_EQ(array[0], first);
+
+    // Пул не получил фигуру, которая осталась в массиве
+    std::unique_ptr<RegularHexagon> fresh(array.acquire<RegularHexagon>());
+    EXPECT_NE(fresh.get(), first);
+}
+
+// ==================== CONTAINMENT TESTS ====================
+
+TEST_F(ArrayTest, BoundingBoxAndContains) {
+    Octagon octagon(octagon_vertices);
+    BoundingBox box = octagon.boundingBox();
+
+    EXPECT_DOUBLE_EQ(box.minX, -1);
+    EXPECT_DOUBLE_EQ(box.minY, -1);
+    EXPECT_DOUBLE_EQ(box.maxX, 1);
+    EXPECT_DOUBLE_EQ(box.maxY, 1);
+
+    EXPECT_TRUE(octagon.contains({0.5, 0.5}));
+    EXPECT_TRUE(octagon.contains({-0.5, -0.5}));
+    EXPECT_FALSE(octagon.contains({2, 0}));
+    EXPECT_FALSE(Pentagon().contains({0, 0}));
+}
+
+TEST_F(ArrayTest, ContainmentIndexQuery) {
+    Array array;
+    array.addFigure(new Pentagon(pentagon_vertices));
+    array.addFigure(new Hexagon(hexagon_vertices));
+    array.addFigure(new Octagon(octagon_vertices));
+
+    ContainmentIndex index(array);
+    auto hits = index.query(std::vector<Point>{{0.5, 0.5}, {0.5, 1.2}, {-0.9, -0.9}, {5, 5}});
+
+    ASSERT_EQ(hits.size(), 4);
+    EXPECT_EQ(hits[0], (std::vector<size_t>{0, 1, 2}));
+    EXPECT_EQ(hits[1], (std::vector<size_t>{0}));
+    EXPECT_EQ(hits[2], (std::vector<size_t>{2}));
+    EXPECT_TRUE(hits[3].empty());
+}
+
+TEST_F(ArrayTest, ContainmentIndexMatchesFigureContains) {
+    Array array;
+    for (int i = 0; i < 10; ++i) {
+        std::vector<Point> shifted;
+        for (const auto& p : hexagon_vertices) {
+            shifted.push_back({p.x + i * 0.3, p.y - i * 0.2});
+        }
+        array.addFigure(new Hexagon(shifted));
+    }
+
+    ContainmentIndex index(array);
+    for (double x = -1; x <= 4; x += 0.37) {
+        for (double y = -3; y <= 1.5; y += 0.29) {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < array.size(); ++i) {
+                if (array[static_cast<int>(i)]->contains({x, y})) expected.push_back(i);
+            }
+            EXPECT_EQ(index.query(Point(x, y)), expected);
+        }
+    }
+}
+
+TEST_F(ArrayTest, ContainmentIndexGridMatchesLinearScan) {
+    // Фигуры разного размера попадают в одну или несколько ячеек сетки
+    Array array;
+    for (int i = 0; i < 400; ++i) {
+        double cx = (i * 37) % 100, cy = (i * 61) % 100, r = 0.5 + (i % 7);
+        array.addFigure(new RegularHexagon(Point(cx, cy), r, i * 0.1));
+    }
+
+    ContainmentIndex index(array);
+    std::vector<Point> points;
+    for (double x = -5; x <= 105; x += 2.3) {
+        for (double y = -5; y <= 105; y += 3.1) {
+            points.push_back({x, y});
+        }
+    }
+
+    auto hits = index.query(points);
+    for (size_t p = 0; p < points.size(); ++p) {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < array.size(); ++i) {
+            if (array.get(i)->contains(points[p])) expected.push_back(i);
+        }
+        EXPECT_EQ(hits[p], expected);
+    }
+}
+
+// ==================== OVERLAP TESTS ====================
+
+TEST_F(ArrayTest, FigureOverlaps) {
+    Hexagon hexagon(hexagon_vertices);
+    Octagon octagon(octagon_vertices);
+    Pentagon farAway({{10,10}, {11,10}, {11,11}, {10.5,11.5}, {10,11}});
+    Pentagon touching({{1,0}, {2,0}, {2,1}, {1.5,1.5}, {1,1}});
+
+    EXPECT_TRUE(hexagon.overlaps(octagon));
+    EXPECT_FALSE(hexagon.overlaps(farAway));
+    EXPECT_FALSE(octagon.overlaps(touching));
+}
+
+TEST_F(ArrayTest, FindOverlappingPairs) {
+    Array array;
+    array.addFigure(new Pentagon({{10,10}, {11,10}, {11,11}, {10.5,11.5}, {10,11}}));
+    array.addFigure(new Hexagon(hexagon_vertices));
+    array.addFigure(new Pentagon({{1,0}, {2,0}, {2,1}, {1.5,1.5}, {1,1}}));
+    array.addFigure(new Octagon(octagon_vertices));
+    array.addFigure(new Pentagon({{10.5,10.5}, {12,10.5}, {12,12}, {11,13}, {10.5,12}}));
+
+    auto pairs = array.findOverlappingPairs();
+    std::vector<std::pair<size_t, size_t>> expected = {{0, 4}, {1, 3}};
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST_F(ArrayTest, FindOverlappingPairsMatchesBruteForce) {
+    Array array;
+    for (int i = 0; i < 40; ++i) {
+        std::vector<Point> shifted;
+        for (const auto& p : octagon_vertices) {
+            shifted.push_back({p.x + (i % 8) * 1.7, p.y + (i / 8) * 1.3});
+        }
+        array.addFigure(new Octagon(shifted));
+    }
+
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t i = 0; i < array.size(); ++i) {
+        for (size_t j = i + 1; j < array.size(); ++j) {
+            if (array[static_cast<int>(i)]->overlaps(*array[static_cast<int>(j)])) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(array.findOverlappingPairs(), expected);
+}
+
+TEST_F(ArrayTest, FindOverlappingPairsAcrossSweepChunks) {
+    // Достаточно фигур, чтобы проход делился на куски на многоядерной машине
+    Array array;
+    for (int i = 0; i < 2500; ++i) {
+        double x = (i * 7919 % 2500) * 0.8, y = (i % 5) * 1.5, r = 0.5 + (i % 3) * 0.4;
+        array.addFigure(new RegularHexagon(Point(x, y), r, i * 0.01));
+    }
+
+    std::vector<BoundingBox> boxes;
+    for (const Figure* figure : array) {
+        boxes.push_back(figure->boundingBox());
+    }
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t i = 0; i < array.size(); ++i) {
+        for (size_t j = i + 1; j < array.size(); ++j) {
+            if (boxes[i].intersects(boxes[j]) && array.get(i)->overlaps(*array.get(j))) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(array.findOverlappingPairs(), expected);
+}
+
+// ==================== REGRESSION GATES ====================
+
+// Считает вызовы area(), чтобы проверять сложность операций Array
+class CountingHexagon : public Hexagon {
+public:
+    static inline size_t areaCalls = 0;
+
+    using Hexagon::Hexagon;
+
+    double area() const override {
+        areaCalls++;
+        return Hexagon::area();
+    }
+};
+
+// Считает сбросы буфера потока
+class FlushCountingBuffer : public std::stringbuf {
+public:
+    size_t flushes = 0;
+
+protected:
+    int sync() override {
+        flushes++;
+        return std::stringbuf::sync();
+    }
+};
+
+class RegressionTest : public ArrayTest {
+protected:
+    template <typename Func>
+    size_t allocationsOf(Func func) {
+        size_t before = allocationCount;
+        func();
+        return allocationCount - before;
+    }
+};
+
+TEST_F(RegressionTest, AreaAndCenterDoNotAllocate) {
+    Pentagon pentagon(pentagon_vertices);
+    Hexagon hexagon(hexagon_vertices);
+    Octagon octagon(octagon_vertices);
+    RegularHexagon regular(Point(1, 1), 2.0);
+
+    double sink = 0;
+    EXPECT_EQ(allocationsOf([&] {
+        for (const Figure* figure : std::initializer_list<const Figure*>{&pentagon, &hexagon, &octagon, &regular}) {
+            sink += figure->area();
+            sink += figure->center().x;
+        }
+    }), 0);
+    EXPECT_GT(sink, 0);
+}
+
+TEST_F(RegressionTest, TotalAreaIsSingleAllocationFreePass) {
+    Array array;
+    for (int i = 0; i < 100; ++i) {
+        array.addFigure(new CountingHexagon(hexagon_vertices));
+    }
+
+    CountingHexagon::areaCalls = 0;
+    double total = 0;
+    EXPECT_EQ(allocationsOf([&] { total = array.totalArea(); }), 0);
+    EXPECT_EQ(CountingHexagon::areaCalls, 100);
+    EXPECT_NEAR(total, 100 * Hexagon(hexagon_vertices).area(), 1e-9);
+}
+
+TEST_F(RegressionTest, RankingComputesEachKeyOnce) {
+    Array array;
+    for (int i = 0; i < 100; ++i) {
+        std::vector<Point> scaled;
+        for (const auto& p : hexagon_vertices) {
+            scaled.push_back({p.x * (1 + i % 13), p.y});
+        }
+        array.addFigure(new CountingHexagon(scaled));
+    }
+
+    CountingHexagon::areaCalls = 0;
+    array.sortBy(Metric::Area);
+    EXPECT_EQ(CountingHexagon::areaCalls, 100);
+
+    CountingHexagon::areaCalls = 0;
+    array.topK(Metric::Area, 10);
+    EXPECT_EQ(CountingHexagon::areaCalls, 100);
+}
+
+TEST_F(RegressionTest, MovesDoNotAllocate) {
+    Pentagon pentagon(pentagon_vertices);
+    Array array1;
+    array1.addFigure(new Pentagon(pentagon_vertices));
+    array1.addFigure(new Hexagon(hexagon_vertices));
+    array1.removeFigure(1);
+    Array array3;
+    array3.addFigure(new Octagon(octagon_vertices));
+
+    EXPECT_EQ(allocationsOf([&] {
+        Pentagon moved(std::move(pentagon));
+        Array array2(std::move(array1));
+        array3 = std::move(array2);
+    }), 0);
+    EXPECT_EQ(array3.size(), 1);
+    EXPECT_EQ(array3.pooledCount(), 1);
+}
+
+TEST_F(RegressionTest, AddFigureGrowsStorageGeometrically) {
+    const size_t count = 1 << 12;
+    std::vector<Figure*> figures;
+    for (size_t i = 0; i < count; ++i) {
+        figures.push_back(new Pentagon(pentagon_vertices));
+    }
+
+    Array array;
+    size_t allocations = allocationsOf([&] {
+        for (Figure* figure : figures) {
+            array.addFigure(figure);
+        }
+    });
+    // Удвоение емкости: не больше log2(count) + 1 выделений
+    EXPECT_LE(allocations, 13);
+}
+
+TEST_F(RegressionTest, PrintAllFiguresDoesNotFlushPerLine) {
+    Array array;
+    for (int i = 0; i < 10; ++i) {
+        array.addFigure(new Octagon(octagon_vertices));
+    }
+
+    FlushCountingBuffer buffer;
+    std::ostream os(&buffer);
+    array.printAllFigures(os);
+
+    EXPECT_EQ(buffer.flushes, 0);
+    std::string output = buffer.str();
+    EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 10);
+}
+
 // ==================== EDGE CASES ====================
 
 TEST(EdgeCaseTest, DegeneratePentagon) {